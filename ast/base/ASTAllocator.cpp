@@ -2,7 +2,10 @@
 
 #include "ASTAllocator.h"
 #include <mutex>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <thread>
 #include "cstring"
 #include "libtcc.h"
 
@@ -16,9 +19,53 @@ BatchAllocator::BatchAllocator(std::size_t heapBatchSize) : heap_offset(heapBatc
 }
 
 
+struct ASTThreadArena {
+    std::thread::id owner;
+    char* current;
+    char* end;
+    std::vector<ASTAny*> ptr_storage;
+    std::vector<ASTCleanupFunction> cleanup_fns;
+};
+
+/**
+ * maximum size of a chunk carved out for a thread arena
+ */
+static constexpr std::size_t ARENA_MAX_CHUNK_SIZE = 16384;
+
+/**
+ * chunks smaller than this aren't worth it, allocations will take the locked path
+ */
+static constexpr std::size_t ARENA_MIN_CHUNK_SIZE = 1024;
+
+/**
+ * the number of (allocator, arena) pairs each thread remembers, a thread usually
+ * allocates from the job, module and file allocators
+ */
+static constexpr unsigned int ARENA_CACHE_SIZE = 4;
+
+struct ArenaCacheEntry {
+    std::uint64_t epoch;
+    ASTThreadArena* arena;
+};
+
+static std::atomic<std::uint64_t> next_arena_epoch{1};
+
+static thread_local ArenaCacheEntry arena_cache[ARENA_CACHE_SIZE] = {};
+
+static thread_local unsigned int arena_cache_next = 0;
+
+static inline std::uint64_t new_arena_epoch() {
+    return next_arena_epoch.fetch_add(1, std::memory_order_relaxed);
+}
+
+static inline std::size_t compute_arena_chunk_size(std::size_t heapBatchSize) {
+    const auto size = heapBatchSize < ARENA_MAX_CHUNK_SIZE ? heapBatchSize : ARENA_MAX_CHUNK_SIZE;
+    return size < ARENA_MIN_CHUNK_SIZE ? 0 : size;
+}
+
 ASTAllocator::ASTAllocator(
     std::size_t heapBatchSize
-) : BatchAllocator(heapBatchSize) {
+) : BatchAllocator(heapBatchSize), arena_epoch(new_arena_epoch()), arena_chunk_size(compute_arena_chunk_size(heapBatchSize)) {
     ptr_storage.reserve(PTR_VEC_SIZE);
     cleanup_fns.reserve(PTR_VEC_SIZE);
 }
@@ -35,8 +82,11 @@ BatchAllocator::BatchAllocator(
 ASTAllocator::ASTAllocator(
     ASTAllocator&& other
 ) noexcept : BatchAllocator(std::move(other)), ptr_storage(std::move(other.ptr_storage)),
-    cleanup_fns(std::move(other.cleanup_fns))
+    thread_arenas(std::move(other.thread_arenas)), arena_epoch(other.arena_epoch),
+    arena_chunk_size(other.arena_chunk_size), cleanup_fns(std::move(other.cleanup_fns))
 {
+    // arenas moved along with their epoch, so caches in threads remain valid
+    other.arena_epoch = new_arena_epoch();
 }
 
 BatchAllocator& BatchAllocator::operator =(BatchAllocator&& other) noexcept {
@@ -55,14 +105,23 @@ BatchAllocator& BatchAllocator::operator =(BatchAllocator&& other) noexcept {
 }
 
 ASTAllocator& ASTAllocator::operator =(ASTAllocator&& other) noexcept {
+    // our objects live in our heap memory, which is released below, so destruct them first
+    destruct_thread_arenas();
+    destruct_cleanup_storage();
+    destruct_ptr_storage();
     BatchAllocator::operator=(std::move(other));
     ptr_storage = std::move(other.ptr_storage);
     cleanup_fns = std::move(other.cleanup_fns);
+    thread_arenas = std::move(other.thread_arenas);
+    arena_epoch = other.arena_epoch;
+    arena_chunk_size = other.arena_chunk_size;
+    other.arena_epoch = new_arena_epoch();
     return *this;
 }
 
 void ASTAllocator::clear() {
     std::lock_guard<std::mutex> lock(*((std::mutex*) allocator_mutex));
+    destruct_thread_arenas();
     destruct_ptr_storage();
     destruct_cleanup_storage();
     if(heap_memory.empty()) {
@@ -105,7 +164,23 @@ void ASTAllocator::destruct_cleanup_storage() {
     cleanup_fns.clear();
 }
 
+void ASTAllocator::destruct_thread_arenas() {
+    for(const auto arena : thread_arenas) {
+        for(auto& fn : arena->cleanup_fns) {
+            fn.cleanup_fn(fn.instance_ptr);
+        }
+        for(const auto ptr : arena->ptr_storage) {
+            ptr->~ASTAny();
+        }
+        delete arena;
+    }
+    thread_arenas.clear();
+    // cached arenas in threads must not match anymore
+    arena_epoch = new_arena_epoch();
+}
+
 ASTAllocator::~ASTAllocator() {
+    destruct_thread_arenas();
     destruct_cleanup_storage();
     destruct_ptr_storage();
 }
@@ -148,7 +223,68 @@ char* BatchAllocator::object_heap_pointer(std::size_t obj_size, std::size_t alig
     }
 }
 
+ASTThreadArena* ASTAllocator::thread_arena() {
+    const auto epoch = arena_epoch;
+    for(auto& entry : arena_cache) {
+        if(entry.epoch == epoch) {
+            return entry.arena;
+        }
+    }
+    const auto thread_id = std::this_thread::get_id();
+    ASTThreadArena* arena = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(*((std::mutex*) allocator_mutex));
+        // the arena may have been evicted from the cache, a thread has a single arena per allocator
+        for(const auto existing : thread_arenas) {
+            if(existing->owner == thread_id) {
+                arena = existing;
+                break;
+            }
+        }
+        if(arena == nullptr) {
+            arena = new ASTThreadArena{ thread_id, nullptr, nullptr, {}, {} };
+            arena->ptr_storage.reserve(PTR_VEC_SIZE);
+            thread_arenas.emplace_back(arena);
+        }
+    }
+    auto& slot = arena_cache[arena_cache_next];
+    arena_cache_next = (arena_cache_next + 1) % ARENA_CACHE_SIZE;
+    slot.epoch = epoch;
+    slot.arena = arena;
+    return arena;
+}
+
+char* ASTAllocator::arena_pointer(ASTThreadArena* arena, std::size_t obj_size, std::size_t alignment) {
+    assert(is_power_of_two(alignment) && "Alignment must be a power of two");
+    auto aligned = (char*) (((uintptr_t) arena->current + alignment - 1) & ~(uintptr_t) (alignment - 1));
+    if(arena->current != nullptr && aligned + obj_size <= arena->end) {
+        arena->current = aligned + obj_size;
+        return aligned;
+    }
+    // large objects would waste most of a chunk, they go through the locked path
+    if(obj_size + alignment > arena_chunk_size / 4) {
+        return nullptr;
+    }
+    char* chunk;
+    {
+        std::lock_guard<std::mutex> lock(*((std::mutex*) allocator_mutex));
+        chunk = object_heap_pointer(arena_chunk_size, alignof(std::max_align_t));
+    }
+    arena->end = chunk + arena_chunk_size;
+    aligned = (char*) (((uintptr_t) chunk + alignment - 1) & ~(uintptr_t) (alignment - 1));
+    arena->current = aligned + obj_size;
+    return aligned;
+}
+
 char* ASTAllocator::allocate_size(std::size_t obj_size, std::size_t alignment) {
+    if(arena_chunk_size != 0) {
+        const auto arena = thread_arena();
+        const auto ptr = arena_pointer(arena, obj_size, alignment);
+        if(ptr) {
+            arena->ptr_storage.emplace_back((ASTAny*) (void*) ptr);
+            return ptr;
+        }
+    }
     std::lock_guard<std::mutex> lock(*((std::mutex*) allocator_mutex));
     const auto ptr = object_heap_pointer(obj_size, alignment);
     store_ptr((ASTAny*) (void*) ptr);
@@ -156,6 +292,14 @@ char* ASTAllocator::allocate_size(std::size_t obj_size, std::size_t alignment) {
 }
 
 char* ASTAllocator::allocate_with_cleanup(std::size_t obj_size, std::size_t alignment, void* cleanup_fn) {
+    if(arena_chunk_size != 0) {
+        const auto arena = thread_arena();
+        const auto ptr = arena_pointer(arena, obj_size, alignment);
+        if(ptr) {
+            arena->cleanup_fns.emplace_back((void*) ptr, (void(*)(void*)) cleanup_fn);
+            return ptr;
+        }
+    }
     std::lock_guard<std::mutex> lock(*((std::mutex*) allocator_mutex));
     const auto ptr = object_heap_pointer(obj_size, alignment);
     store_cleanup_fn((void*) ptr, cleanup_fn);
@@ -11,6 +11,13 @@ struct ASTCleanupFunction {
     void(*cleanup_fn)(void*);
 };
 
+/**
+ * a thread arena is a chunk carved out of the allocator's heap batches that is
+ * owned by a single thread, allocations from the arena don't take the allocator
+ * mutex, the arena keeps its own pointer storage so destruction doesn't need it either
+ */
+struct ASTThreadArena;
+
 /**
  * ASTAllocator is supposed to be the simplest class that allows
  * to allocate different AST classes, It stores pointers to the allocated
@@ -96,6 +103,24 @@ protected:
      */
     std::vector<ASTAny*> ptr_storage;
 
+    /**
+     * arenas handed out to threads that allocated using this allocator, these are
+     * destructed (and their chunks returned) when the allocator is cleared or dies
+     */
+    std::vector<ASTThreadArena*> thread_arenas;
+
+    /**
+     * a globally unique id, threads cache their arena against this id, it's renewed
+     * whenever the arenas are released, so stale thread local caches never match
+     */
+    std::uint64_t arena_epoch;
+
+    /**
+     * the size of the chunk carved out for a thread arena, zero means
+     * thread arenas are disabled for this allocator
+     */
+    std::size_t arena_chunk_size;
+
     /**
      * these functions are run at destruction, we can basically
      * store any object and it's destructor in this struct, and call it
@@ -119,4 +144,21 @@ protected:
      */
     void destruct_cleanup_storage();
 
+    /**
+     * get the arena for the current thread, creating it if this thread
+     * hasn't allocated using this allocator before
+     */
+    ASTThreadArena* thread_arena();
+
+    /**
+     * bump allocate from the current thread's arena, returns null if object
+     * is too large for an arena, in which case the locked path must be used
+     */
+    char* arena_pointer(ASTThreadArena* arena, std::size_t obj_size, std::size_t alignment);
+
+    /**
+     * destructs the objects allocated in thread arenas and releases the arenas
+     */
+    void destruct_thread_arenas();
+
 };
\ No newline at end of file
@@ -728,13 +728,11 @@ bool ASTNode::requires_moving(ASTNodeKind k) {
 }
 
 ASTNode* child(VariablesContainerBase* container, const chem::string_view& name) {
-    auto found = container->indexes.find(name);
-    return found != container->indexes.end() ? found->second : nullptr;
+    return container->indexes.find(name);
 }
 
 ASTNode* child(VariablesContainer* container, const chem::string_view& name) {
-    auto found = container->indexes.find(name);
-    return found != container->indexes.end() ? found->second : nullptr;
+    return container->indexes.find(name);
 }
 
 ASTNode* provide_child(const ChildResolver* resolver, BaseType* type, const chem::string_view& name, ASTNode* type_parent);
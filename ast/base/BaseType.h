@@ -188,11 +188,6 @@ public:
         return is_same(type);
     }
 
-    /**
-     * will get the generic iteration or -1 if this type can't provide one
-     */
-    int16_t get_generic_iteration();
-
     /**
      * whether the given value satisfies the current type
      */
@@ -56,7 +56,7 @@ public:
  * add an extension function
  */
     inline void add_extension_func(const chem::string_view& name, FunctionDeclaration* decl) {
-        indexes[name] = (ASTNode*) decl;
+        indexes.set(name, (ASTNode*) decl);
         extension_functions.emplace_back((ASTNode*) decl);
     }
 
@@ -64,7 +64,7 @@ public:
      * add extension function
      */
     inline void add_extension_func(const chem::string_view& name, GenericFuncDecl* decl) {
-        indexes[name] = (ASTNode*) decl;
+        indexes.set(name, (ASTNode*) decl);
         extension_functions.emplace_back((ASTNode*) decl);
     }
 
@@ -17,7 +17,7 @@ GlobalInterpretScope::GlobalInterpretScope(
     bool interpretation_mode
 ) : ASTDiagnoser(loc_man), InterpretScope(nullptr, allocator, this), mode(mode), target_data(target_data),
     backend_context(context), build_compiler(buildCompiler), allocator(allocator), typeBuilder(typeBuilder),
-    interpretation_mode(interpretation_mode) {
+    interpretation_mode(interpretation_mode), memo(std::make_unique<ComptimeMemo>()) {
     // Global scope should not destruct values - it's reused and outlives individual interpretations
     should_destruct_values = false;
 }
@@ -15,6 +15,7 @@
 #include "compiler/lab/TargetData.h"
 #include "TypeLoc.h"
 #include "compiler/OutputMode.h"
+#include "compiler/Interpreter/ComptimeMemo.h"
 
 class BackendContext;
 
@@ -107,6 +108,11 @@ public:
      */
     Value* loop_break_value = nullptr;
 
+    /**
+     * results of pure comptime function calls, shared by all modules of the job
+     */
+    std::unique_ptr<ComptimeMemo> memo;
+
     /**
      * The constructor
      */
@@ -566,7 +566,9 @@ InterpretScope::~InterpretScope() {
 }
 
 void InterpretScope::destroy_values() {
-    for(auto& [name, val] : values) {
+    // values are destructed in reverse order of declaration, like the C backend does
+    for(auto it = values.rbegin(); it != values.rend(); ++it) {
+        const auto val = it->second;
         if (val == nullptr) continue;
         // Skip the return value (it's been moved to the caller)
         if(val == returnValue) continue;
@@ -720,6 +722,8 @@ void InterpretScope::move_clear_source(Value* initializer, const chem::string_vi
 void InterpretScope::print_values() {
     std::cout << "Values:" << std::endl;
     for (auto const &value: values) {
+        // skipping erased and undefined values
+        if(value.second == nullptr) continue;
         std::cout << value.first << " : " << value.second->representation() << std::endl;
     }
     if(parent != nullptr) {
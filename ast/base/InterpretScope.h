@@ -8,6 +8,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "ASTNode.h"
 #include "ast/base/ASTAllocator.h"
@@ -30,7 +31,170 @@ class ASTDiagnoser;
 
 using node_map = std::unordered_map<chem::string_view, ASTNode*>;
 using node_iterator = node_map::iterator;
-using value_map = std::unordered_map<chem::string_view, Value*>;
+
+/**
+ * values of an interpret scope, stored flat in declaration order, every call and block of a
+ * comptime function creates a scope holding a few locals, these are found faster by comparing
+ * names than by hashing them, and declaring a value doesn't allocate a node, once a scope
+ * holds many values (the global scope) an index from name to slot is kept alongside
+ *
+ * erasing a value leaves a tombstone (a slot with an empty name and a null value) in its place,
+ * so a value's position never changes while it's in the map, iteration visits tombstones too
+ */
+class InterpretValueMap {
+public:
+
+    using value_type = std::pair<chem::string_view, Value*>;
+    using iterator = std::vector<value_type>::iterator;
+
+    inline iterator begin() noexcept {
+        return slots.begin();
+    }
+
+    inline iterator end() noexcept {
+        return slots.end();
+    }
+
+    inline auto rbegin() noexcept {
+        return slots.rbegin();
+    }
+
+    inline auto rend() noexcept {
+        return slots.rend();
+    }
+
+    inline std::size_t size() const noexcept {
+        return slots.size() - tombstones;
+    }
+
+    inline bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    /**
+     * the position of the value at given iterator, which stays valid until the value is
+     * erased, unlike iterators, which are invalidated when a value is declared
+     */
+    inline std::size_t position(iterator it) noexcept {
+        return static_cast<std::size_t>(it - slots.begin());
+    }
+
+    /**
+     * get the value at the given position
+     */
+    inline value_type& at(std::size_t position) noexcept {
+        return slots[position];
+    }
+
+    /**
+     * find the value with given name, end if not found
+     */
+    iterator find(const chem::string_view& name) {
+        // tombstones have an empty name
+        if(name.empty()) {
+            return slots.end();
+        }
+        if(!index.empty()) {
+            auto found = index.find(name);
+            return found != index.end() ? slots.begin() + found->second : slots.end();
+        }
+        // later declarations are usually looked up more often
+        auto it = slots.end();
+        while(it != slots.begin()) {
+            --it;
+            if(it->first == name) {
+                return it;
+            }
+        }
+        return slots.end();
+    }
+
+    /**
+     * get the value with given name, declaring it (as null) if it doesn't exist
+     */
+    Value*& operator[](const chem::string_view& name) {
+        auto found = find(name);
+        if(found != slots.end()) {
+            return found->second;
+        }
+        slots.emplace_back(name, nullptr);
+        if(!index.empty()) {
+            index.emplace(name, static_cast<unsigned int>(slots.size() - 1));
+        } else if(size() > INDEX_THRESHOLD) {
+            build_index();
+        }
+        return slots.back().second;
+    }
+
+    /**
+     * erase the value at given iterator, it's replaced with a tombstone, so positions of
+     * other values don't change, returns the iterator to the next slot
+     */
+    iterator erase(iterator it) {
+        if(!index.empty()) {
+            index.erase(it->first);
+        }
+        it->first = chem::string_view();
+        it->second = nullptr;
+        tombstones++;
+        if(it + 1 != slots.end()) {
+            return it + 1;
+        }
+        // trailing tombstones are dropped, no value comes after them
+        while(!slots.empty() && slots.back().first.empty()) {
+            slots.pop_back();
+            tombstones--;
+        }
+        return slots.end();
+    }
+
+    /**
+     * erase the value with given name, returns the number of values erased
+     */
+    std::size_t erase(const chem::string_view& name) {
+        auto found = find(name);
+        if(found == slots.end()) {
+            return 0;
+        }
+        erase(found);
+        return 1;
+    }
+
+    void clear() {
+        slots.clear();
+        index.clear();
+        tombstones = 0;
+    }
+
+private:
+
+    /**
+     * scopes with values more than this are indexed
+     */
+    static constexpr std::size_t INDEX_THRESHOLD = 16;
+
+    void build_index() {
+        index.clear();
+        index.reserve(slots.size() * 2);
+        for(unsigned int i = 0; i < slots.size(); i++) {
+            if(!slots[i].first.empty()) {
+                index.emplace(slots[i].first, i);
+            }
+        }
+    }
+
+    std::vector<value_type> slots;
+
+    /**
+     * number of erased slots in the middle of slots
+     */
+    std::size_t tombstones = 0;
+
+    std::unordered_map<chem::string_view, unsigned int> index;
+
+};
+
+using value_map = InterpretValueMap;
 using value_iterator = value_map::iterator;
 
 class FunctionType;
@@ -41,7 +205,7 @@ public:
     /**
       * This contains a map between identifiers and its values, of the current scope
       */
-    std::unordered_map<chem::string_view, Value*> values;
+    value_map values;
 
     /**
      * a pointer to the parent scope, If this is a global scope, it will be a nullptr
@@ -7,7 +7,9 @@
 #pragma once
 
 #include "ast/base/ASTNode.h"
+#include "compiler/symres/SymbolTable.h"
 #include <unordered_map>
+#include <mutex>
 
 /**
  * node solely used to contain children, we store the pointer to this node
@@ -21,6 +23,17 @@ public:
      */
     std::unordered_map<chem::string_view, ASTNode*> symbols;
 
+    /**
+     * the symbols as a layer, built from the map when it's first needed
+     * and shared by every symbol table it's pushed on
+     */
+    SymbolLayer layer;
+
+    /**
+     * the layer is built once, dependents may be resolved on different threads
+     */
+    std::once_flag layer_built;
+
     /**
      * constructor
      */
@@ -29,4 +42,16 @@ public:
             SourceLocation location
     ) : ASTNode(ASTNodeKind::ChildrenMapNode, parent_node, location) {}
 
+    /**
+     * get the symbols as a layer, the map must not be changed after this is called
+     */
+    const SymbolLayer& get_layer() {
+        std::call_once(layer_built, [this]() {
+            for(auto& sym : symbols) {
+                layer.declare(sym.first, sym.second);
+            }
+        });
+        return layer;
+    }
+
 };
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 #include "ast/base/ASTNode.h"
 #include <thread>
+#include <mutex>
 
 /**
  * determines what register_generic_args does when called:
@@ -39,6 +40,12 @@ public:
      */
     std::vector<InstantiationStatusEntry> instantiation_statuses;
 
+    /**
+     * locked while checking (and maybe registering) an instantiation of this declaration
+     * registrations of different generic declarations don't wait on each other
+     */
+    std::mutex registration_mutex;
+
     /**
      * constructor
      */
@@ -525,22 +525,6 @@ public:
         return (body.has_value()) ? body->encoded_location() : ASTNode::encoded_location();
     }
 
-    /**
-     * we return generic iteration if it already exists
-     */
-    int16_t register_call_with_existing(ASTDiagnoser& diagnoser, FunctionCall* call, BaseType* expected_type);
-
-    void register_parent_iteration(ASTAllocator& astAllocator, ASTDiagnoser& diagnoser, int16_t parent_itr);
-
-    int16_t get_parent_iteration();
-
-    /**
-     * a call notifies a function, during symbol resolution that it exists
-     * when this happens, generics are checked, proper types are registered in generic
-     * @return iteration that corresponds to this call
-     */
-    int16_t register_call(ASTAllocator& astAllocator, ASTDiagnoser& diagnoser, FunctionCall* call, BaseType* expected_type);
-
     /**
      * get known function type, which is this
      */
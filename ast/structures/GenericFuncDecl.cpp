@@ -50,9 +50,9 @@ FunctionDeclaration* GenericFuncDecl::register_generic_args(
     auto& container = instantiator.getContainer();
     auto& allocator = instantiator.getAllocator();
     auto& diagnoser = instantiator.getDiagnoser();
-    auto& reg_mutex = instantiator.getRegistrationMutex();
+    auto& reg_mutex = registration_mutex;
 
-    // locking the mutex to check (and maybe register) for generic instantiation
+    // locking this declaration's mutex to check (and maybe register) for generic instantiation
     reg_mutex.lock();
 
     // checking
@@ -76,9 +76,9 @@ FunctionDeclaration* GenericFuncDecl::register_generic_args(
         return instantiations[idx];
     }
 
-    if(itr.first != instantiations.size()) {
+    if(itr.first != (int) instantiations.size()) {
         // TODO enable this error, currently when a type deduction fails, we expect the type to be specified in argument list
-        if(itr.first < instantiations.size()) {
+        if(itr.first < (int) instantiations.size()) {
             reg_mutex.unlock();
             return instantiations[itr.first];
         }
@@ -53,9 +53,9 @@ ImplDefinition* GenericImplDecl::register_generic_args(
     auto& container = instantiator.getContainer();
     auto& allocator = instantiator.getAllocator();
     auto& diagnoser = instantiator.getDiagnoser();
-    auto& reg_mutex = instantiator.getRegistrationMutex();
+    auto& reg_mutex = registration_mutex;
 
-    // locking the mutex to check (and maybe register) for generic instantiation
+    // locking this declaration's mutex to check (and maybe register) for generic instantiation
     reg_mutex.lock();
 
     const auto itr = register_generic_usage(allocator, this, container, generic_args, ((std::vector<void*>&) instantiations));
@@ -71,7 +71,7 @@ ImplDefinition* GenericImplDecl::register_generic_args(
 
     const auto impl = master_impl->shallow_copy(allocator);
 
-    if(itr.first != instantiations.size()) {
+    if(itr.first != (int) instantiations.size()) {
 #ifdef DEBUG
         CHEM_THROW_RUNTIME("not the index we expected");
 #endif
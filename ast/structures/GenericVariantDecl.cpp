@@ -56,9 +56,9 @@ VariantDefinition* GenericVariantDecl::register_generic_args(
     auto& container = instantiator.getContainer();
     auto& allocator = instantiator.getAllocator();
     auto& diagnoser = instantiator.getDiagnoser();
-    auto& reg_mutex = instantiator.getRegistrationMutex();
+    auto& reg_mutex = registration_mutex;
 
-    // locking the mutex to check (and maybe register) for generic instantiation
+    // locking this declaration's mutex to check (and maybe register) for generic instantiation
     reg_mutex.lock();
 
     const auto itr = register_generic_usage(allocator, this, container, generic_args, ((std::vector<void*>&) instantiations));
@@ -72,9 +72,14 @@ VariantDefinition* GenericVariantDecl::register_generic_args(
         return instantiations[idx];
     }
 
-    const auto impl = master_impl->shallow_copy(allocator);
+    VariantDefinition* impl;
+    {
+        // extension functions are registered on the master implementation in parallel
+        std::lock_guard<std::recursive_mutex> ext_lock(instantiator.getRegistrationMutex());
+        impl = master_impl->shallow_copy(allocator);
+    }
 
-    if(itr.first != instantiations.size()) {
+    if(itr.first != (int) instantiations.size()) {
 #ifdef DEBUG
         CHEM_THROW_RUNTIME("not the index we expected");
 #endif
@@ -0,0 +1,196 @@
+// Copyright (c) Chemical Language Foundation 2025.
+
+#pragma once
+
+#include "std/chem_string_view.h"
+#include <vector>
+#include <memory>
+#include <functional>
+
+class ASTNode;
+
+/**
+ * index of the members of a container by their names, the names are kept in a flat open
+ * addressing table that maps a name to a slot, the nodes are kept in a vector by slot
+ *
+ * copying the index shares the name table and only copies the slots, generic instantiations
+ * (which are shallow copies of the master implementation) replace the nodes in the slots with
+ * their copies, the name table is copied only when a new name is inserted into a shared index
+ */
+class MemberIndex {
+private:
+
+    static constexpr unsigned int EmptySlot = static_cast<unsigned int>(-1);
+
+    struct Entry {
+        chem::string_view name;
+        std::size_t hash;
+        unsigned int slot = EmptySlot;
+    };
+
+    /**
+     * maps the names to slots, the capacity is always a power of two
+     */
+    struct NameTable {
+        std::vector<Entry> entries;
+        unsigned int count = 0;
+    };
+
+    /**
+     * the names (shared by the copies)
+     */
+    std::shared_ptr<NameTable> names;
+
+    /**
+     * slot → node
+     */
+    std::vector<ASTNode*> nodes;
+
+    /**
+     * finds the slot of the name, EmptySlot if not found
+     */
+    unsigned int find_slot(const chem::string_view& name, std::size_t hash) const noexcept {
+        if(!names || names->count == 0) return EmptySlot;
+        auto& entries = names->entries;
+        const auto mask = entries.size() - 1;
+        auto i = hash & mask;
+        while(entries[i].slot != EmptySlot) {
+            auto& entry = entries[i];
+            if(entry.hash == hash && entry.name == name) {
+                return entry.slot;
+            }
+            i = (i + 1) & mask;
+        }
+        return EmptySlot;
+    }
+
+    /**
+     * puts the entry in the entries, the name must not be present
+     */
+    static void put_entry(std::vector<Entry>& entries, const Entry& entry) noexcept {
+        const auto mask = entries.size() - 1;
+        auto i = entry.hash & mask;
+        while(entries[i].slot != EmptySlot) {
+            i = (i + 1) & mask;
+        }
+        entries[i] = entry;
+    }
+
+    /**
+     * inserts a new name pointing to the given node, the name must not be present
+     */
+    void insert_new(const chem::string_view& name, std::size_t hash, ASTNode* node) {
+        if(!names) {
+            names = std::make_shared<NameTable>();
+        } else if(names.use_count() > 1) {
+            // copy on write, copies keep the table they share
+            names = std::make_shared<NameTable>(*names);
+        }
+        auto& table = *names;
+        // keeping the load factor under a half
+        if((table.count + 1) * 2 > table.entries.size()) {
+            std::vector<Entry> grown(table.entries.empty() ? 8 : table.entries.size() * 2);
+            for(auto& entry : table.entries) {
+                if(entry.slot != EmptySlot) {
+                    put_entry(grown, entry);
+                }
+            }
+            table.entries = std::move(grown);
+        }
+        const auto slot = static_cast<unsigned int>(nodes.size());
+        put_entry(table.entries, Entry{ name, hash, slot });
+        table.count++;
+        nodes.emplace_back(node);
+    }
+
+public:
+
+    /**
+     * get the node with the given name, nullptr if not found
+     */
+    ASTNode* find(const chem::string_view& name) const noexcept {
+        const auto slot = find_slot(name, std::hash<chem::string_view>{}(name));
+        return slot != EmptySlot ? nodes[slot] : nullptr;
+    }
+
+    /**
+     * checks if a node with the given name exists
+     */
+    inline bool contains(const chem::string_view& name) const noexcept {
+        return find(name) != nullptr;
+    }
+
+    /**
+     * inserts the node if no node with the given name exists
+     * @return true if inserted
+     */
+    bool try_emplace(const chem::string_view& name, ASTNode* node) {
+        const auto hash = std::hash<chem::string_view>{}(name);
+        if(find_slot(name, hash) != EmptySlot) {
+            return false;
+        }
+        insert_new(name, hash, node);
+        return true;
+    }
+
+    /**
+     * inserts the node if no node with the given name exists
+     * @return true if inserted
+     */
+    inline bool emplace(const chem::string_view& name, ASTNode* node) {
+        return try_emplace(name, node);
+    }
+
+    /**
+     * sets the node with the given name, replacing the existing one
+     */
+    void set(const chem::string_view& name, ASTNode* node) {
+        const auto hash = std::hash<chem::string_view>{}(name);
+        const auto slot = find_slot(name, hash);
+        if(slot != EmptySlot) {
+            nodes[slot] = node;
+        } else {
+            insert_new(name, hash, node);
+        }
+    }
+
+    /**
+     * inserts the nodes of the other index whose names don't exist in this index
+     */
+    void merge(const MemberIndex& other) {
+        if(other.empty() || &other == this) return;
+        if(empty()) {
+            // nothing to hide, the names are shared
+            *this = other;
+            return;
+        }
+        for(auto& entry : other.names->entries) {
+            if(entry.slot != EmptySlot && find_slot(entry.name, entry.hash) == EmptySlot) {
+                insert_new(entry.name, entry.hash, other.nodes[entry.slot]);
+            }
+        }
+    }
+
+    /**
+     * the number of nodes in the index
+     */
+    inline std::size_t size() const noexcept {
+        return nodes.size();
+    }
+
+    /**
+     * checks if the index is empty
+     */
+    inline bool empty() const noexcept {
+        return nodes.empty();
+    }
+
+    /**
+     * removes all the nodes
+     */
+    void clear() noexcept {
+        names = nullptr;
+        nodes.clear();
+    }
+
+};
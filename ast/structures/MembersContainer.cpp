@@ -870,12 +870,12 @@ bool MembersContainer::any_member_has_destructor() {
 
 void MembersContainer::insert_func(FunctionDeclaration* decl) {
     evaluated_container.emplace_back(decl);
-    indexes[decl->name_view()] = decl;
+    indexes.set(decl->name_view(), decl);
 }
 
 void MembersContainer::insert_func(GenericFuncDecl* decl) {
     evaluated_container.emplace_back(decl);
-    indexes[decl->master_impl->name_view()] = decl;
+    indexes.set(decl->master_impl->name_view(), decl);
 }
 
 void MembersContainer::insert_functions(const std::initializer_list<FunctionDeclaration*>& decls) {
@@ -976,16 +976,16 @@ std::pair<BaseType*, long> VariablesContainer::variable_type_w_index(const chem:
             parents_size += 1;
         }
     }
-    auto found = indexes.find(varName);
-    if(found == indexes.end()) {
+    const auto found = indexes.find(varName);
+    if(found == nullptr) {
         return { nullptr, -1 };
     } else {
-        const auto mem_index = direct_mem_index(found->second->as_base_def_member_unsafe());
+        const auto mem_index = direct_mem_index(found->as_base_def_member_unsafe());
         if(mem_index == -1) {
             // must not be a direct child
             return { nullptr, - 1 };
         }
-        return { found->second->known_type(), mem_index + parents_size };
+        return { found->known_type(), mem_index + parents_size };
     }
 }
 
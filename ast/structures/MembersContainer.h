@@ -177,8 +177,8 @@ public:
      * get inherited or child function or extension function with given name
      */
     FunctionDeclaration* any_child_function(const chem::string_view& name) {
-        auto func = indexes.find(name);
-        return func != indexes.end() ? func->second->as_function() : nullptr;
+        const auto node = indexes.find(name);
+        return node != nullptr ? node->as_function() : nullptr;
     }
 
     /**
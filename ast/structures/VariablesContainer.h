@@ -6,6 +6,7 @@
 #include "BaseDefMember.h"
 #include "InheritedType.h"
 #include "ast/base/BaseType.h"
+#include "MemberIndex.h"
 #include <string>
 #include <memory>
 
@@ -41,7 +42,7 @@ public:
      * contains the pointer to the node, which could be a variable, function (maybe generic)
      * indexes are passed to containers that inherit this container
      */
-    std::unordered_map<chem::string_view, ASTNode*> indexes;
+    MemberIndex indexes;
 
     /**
      * get the variables container
@@ -61,17 +62,15 @@ public:
      * gets any child (inherited or direct)
      */
     ASTNode* any_child(const chem::string_view& name) {
-        auto found = indexes.find(name);
-        return found != indexes.end() ? found->second : nullptr;
+        return indexes.find(name);
     }
 
     /**
      * any child variable (member) inherited / direct
      */
     BaseDefMember* any_child_def_member(const chem::string_view& name) {
-        auto found = indexes.find(name);
-        if(found == indexes.end()) return nullptr;
-        const auto node = found->second;
+        const auto node = indexes.find(name);
+        if(node == nullptr) return nullptr;
         switch(node->kind()) {
             case ASTNodeKind::UnnamedUnion:
             case ASTNodeKind::UnnamedStruct:
@@ -105,19 +104,19 @@ public:
      * get direct variable with its index
      */
     std::pair<BaseType*, long> variable_type_w_index_no_inherited(const chem::string_view &name) {
-        auto found = indexes.find(name);
-        if(found == indexes.end()) return { nullptr, -1 };
-        const auto mem = found->second->as_base_def_member();
+        const auto found = indexes.find(name);
+        if(found == nullptr) return { nullptr, -1 };
+        const auto mem = found->as_base_def_member();
         if(!mem) return { nullptr, -1 };
-        return { mem->known_type(), direct_mem_index(found->second->as_base_def_member_unsafe()) };
+        return { mem->known_type(), direct_mem_index(mem) };
     }
 
     /**
      * get index of a direct variable
      */
     long direct_variable_index_no_inherited(const chem::string_view& varName) {
-        auto found = indexes.find(varName);
-        return found == indexes.end() ? -1 : direct_mem_index(found->second->as_base_def_member_unsafe());
+        const auto found = indexes.find(varName);
+        return found == nullptr ? -1 : direct_mem_index(found->as_base_def_member_unsafe());
     }
 
     /**
@@ -150,8 +149,7 @@ public:
      * insert a variable into this container
      */
     bool insert_variable(BaseDefMember* member) {
-        auto found = indexes.find(member->name);
-        if(found == indexes.end()) {
+        if(!indexes.contains(member->name)) {
             insert_variable_no_check(member);
             return true;
         } else {
@@ -286,7 +284,7 @@ public:
             const auto copied = var->copy_member(allocator);
             copied->set_parent(new_parent);
             var = copied;
-            indexes[copied->name] = copied;
+            indexes.set(copied->name, copied);
             i++;
         }
     }
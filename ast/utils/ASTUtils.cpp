@@ -12,6 +12,7 @@
 #include "ast/types/GenericType.h"
 #include "ast/types/PointerType.h"
 #include "ast/types/ReferenceType.h"
+#include "ast/types/IntNType.h"
 #include "GenericUtils.h"
 #include "compiler/SymbolResolver.h"
 
@@ -175,38 +176,127 @@ void infer_generic_args(
 
 }
 
-int16_t get_iteration_for(
+static inline bool is_same_instantiation(std::span<BaseType*> instantiation, std::vector<TypeLoc>& generic_list) {
+    unsigned j = 0;
+    for(const auto instType : instantiation) {
+        const auto generic_arg_pure = generic_list[j];
+        if(!generic_arg_pure || !instType->canonical()->is_same(generic_arg_pure->canonical())) {
+            return false;
+        }
+        j++;
+    }
+    return true;
+}
+
+int get_iteration_for(
         const std::span<std::span<BaseType*>>& instantiations,
         std::vector<TypeLoc>& generic_list
 ) {
-    if(instantiations.empty()) return -1;
-    int16_t i = 0;
-    unsigned j;
     const auto total = instantiations.size();
-    while(i < total) {
-        bool all_params_found = true;
-        auto& instantiation = instantiations[i];
-        j = 0;
-        for(const auto instType : instantiation) {
-            const auto generic_arg_pure = generic_list[j];
-            if(!generic_arg_pure || !instType->canonical()->is_same(generic_arg_pure->canonical())) {
-                all_params_found = false;
+    for(unsigned i = 0; i < total; i++) {
+        if(is_same_instantiation(instantiations[i], generic_list)) {
+            return (int) i;
+        }
+    }
+    return -1;
+}
+
+static inline void hash_combine(std::size_t& seed, std::size_t value) {
+    seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+/**
+ * hashes the type structurally, types that are same (is_same) after canonicalization
+ * always produce the same hash, returns false for types that can't be hashed, because they
+ * match loosely (generic parameters) or their canonical form can change
+ */
+static bool hash_instantiation_type(BaseType* type, std::size_t& seed) {
+    if(type->kind() == BaseTypeKind::Linked) {
+        const auto linked = type->as_linked_type_unsafe()->linked;
+        if(!linked || linked->kind() == ASTNodeKind::GenericTypeParam) {
+            return false;
+        }
+    }
+    const auto can = type->canonical();
+    const auto kind = can->kind();
+    hash_combine(seed, (std::size_t) kind);
+    switch(kind) {
+        case BaseTypeKind::Linked: {
+            const auto linked = can->as_linked_type_unsafe()->linked;
+            if(!linked || linked->kind() == ASTNodeKind::GenericTypeParam) {
+                return false;
+            }
+            hash_combine(seed, std::hash<void*>{}(linked));
+            return true;
+        }
+        case BaseTypeKind::Generic: {
+            const auto gen = can->as_generic_type_unsafe();
+            const auto linked = gen->referenced->linked;
+            if(!linked) {
+                return false;
+            }
+            hash_combine(seed, std::hash<void*>{}(linked));
+            for(auto& arg : gen->types) {
+                if(!hash_instantiation_type(arg, seed)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case BaseTypeKind::Pointer:
+            return hash_instantiation_type(can->as_pointer_type_unsafe()->type, seed);
+        case BaseTypeKind::Reference:
+            return hash_instantiation_type(can->as_reference_type_unsafe()->type, seed);
+        case BaseTypeKind::IntN:
+            hash_combine(seed, (std::size_t) can->as_intn_type_unsafe()->IntNKind());
+            return true;
+        default:
+            // every other type compares its kind when checking is same
+            return true;
+    }
+}
+
+static InstantiationHash hash_generic_list(std::vector<TypeLoc>& generic_list) {
+    std::size_t seed = generic_list.size();
+    for(auto& arg : generic_list) {
+        if(!arg || !hash_instantiation_type(const_cast<BaseType*>(arg.getType()), seed)) {
+            return { 0, false };
+        }
+    }
+    return { seed, true };
+}
+
+/**
+ * finds the first matching instantiation, only the instantiations with the same hash
+ * and the ones that couldn't be hashed are compared
+ */
+static int find_iteration_for(DeclInstantiations& decl, InstantiationHash hash, std::vector<TypeLoc>& generic_list) {
+    if(!hash.hashed) {
+        return get_iteration_for(decl.types, generic_list);
+    }
+    int found = -1;
+    const auto candidates = decl.hashIndex.find(hash.value);
+    if(candidates != decl.hashIndex.end()) {
+        for(const auto index : candidates->second) {
+            if(is_same_instantiation(decl.types[index], generic_list)) {
+                found = (int) index;
                 break;
             }
-            j++;
         }
-        if(all_params_found) {
+    }
+    // indexes are in registration order, so we stop at the one found already
+    for(const auto index : decl.unhashed) {
+        if(found != -1 && index >= (unsigned) found) {
             break;
         }
-        i++;
-    }
-    if(i == total) {
-        return -1;
+        if(is_same_instantiation(decl.types[index], generic_list)) {
+            return (int) index;
+        }
     }
-    return i;
+    return found;
 }
 
-std::pair<int16_t, bool> register_generic_usage(
+std::pair<int, bool> register_generic_usage(
         ASTAllocator& astAllocator,
         void* key,
         InstantiationsContainer& container,
@@ -215,9 +305,12 @@ std::pair<int16_t, bool> register_generic_usage(
 ) {
 
     // check if previous instantiation already exists
-    auto instantiations = container.getInstantiationTypesFor(key);
-    auto i = get_iteration_for(instantiations, generic_list);
-    if(i != -1) return { i, false};
+    const auto hash = hash_generic_list(generic_list);
+    const auto decl = container.getDeclInstantiations(key);
+    if(decl) {
+        const auto i = find_iteration_for(*decl, hash, generic_list);
+        if(i != -1) return { i, false };
+    }
 
     // allocate generic list vector on the allocator (so we can pass it around as a span)
     const auto initial = (BaseType**) astAllocator.allocate_released_size(sizeof(void*) * generic_list.size(), alignof(void*));
@@ -230,8 +323,8 @@ std::pair<int16_t, bool> register_generic_usage(
 
     // register the instantiation
     // TODO: registering with file id
-    const auto index = container.registerInstantiation(key, generic_list_allocated, instVec, 0);
-    return { (int16_t) index, true };
+    const auto index = container.registerInstantiation(key, generic_list_allocated, hash, instVec, 0);
+    return { (int) index, true };
 
 }
 
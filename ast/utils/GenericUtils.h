@@ -13,8 +13,8 @@ class BaseType;
  * get iteration for given generic args, if it exists, otherwise returns -1
  * non generic functions return 0
  */
-int16_t get_iteration_for(
-        const std::vector<std::span<BaseType*>>& instantiations,
+int get_iteration_for(
+        const std::span<std::span<BaseType*>>& instantiations,
         std::vector<TypeLoc>& generic_list
 );
 
@@ -22,7 +22,7 @@ int16_t get_iteration_for(
  * get iteration for given generic args, if it exists, otherwise returns -1
  * non generic functions return 0
  */
-int16_t get_iteration_for(
+int get_iteration_for(
     std::vector<GenericTypeParameter*>& generic_params,
     std::vector<TypeLoc>& generic_list
 );
@@ -35,7 +35,7 @@ int16_t get_iteration_for(
  * this function will put root node of given node on the symbol resolver's map if generic args
  * couldn't find iteration and had to create one
  */
-std::pair<int16_t, bool> register_generic_usage(
+std::pair<int, bool> register_generic_usage(
         ASTAllocator& astAllocator,
         void* key,
         InstantiationsContainer& container,
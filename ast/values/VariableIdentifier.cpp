@@ -212,6 +212,11 @@ void VariableIdentifier::set_value(InterpretScope &scope, Value *rawValue, Opera
         return;
     }
 
+    // evaluating can declare values in the scope of the previous value (invalidating the iterator)
+    // so the previous value is accessed by its position, which doesn't change
+    auto& prev_values = itr.second.values;
+    const auto prev_position = prev_values.position(itr.first);
+
     // first we resolve the value in the current scope
     const auto evalNewValue = rawValue->evaluated_value(scope);
     // now we copy the value onto the scope of the previous value
@@ -225,7 +230,7 @@ void VariableIdentifier::set_value(InterpretScope &scope, Value *rawValue, Opera
     if (op != Operation::Assignment) {
 
         // get the previous value, perform operation on it
-        auto prevValue = itr.first->second;
+        auto prevValue = prev_values.at(prev_position).second;
 
         // Handle operator overloads for compound assignments on struct-like values
         // First, try to get the actual struct value by evaluating (resolves AccessChain, Identifier, etc.)
@@ -317,7 +322,7 @@ void VariableIdentifier::set_value(InterpretScope &scope, Value *rawValue, Opera
                         auto result = overloaded->call(&scope, opArgs, prevValue, &fn_scope, true, this);
                         glob->call_stack.pop_back();
                         glob->current_func_type = prev_func;
-                        itr.first->second = result;
+                        itr.second.declare(value, result);
                         return;
                     }
                 }
@@ -326,10 +331,10 @@ void VariableIdentifier::set_value(InterpretScope &scope, Value *rawValue, Opera
 
         // TODO debug value being passed as this, it should be taken as a parameter
         auto nextValue = itr.second.evaluate(op, prevValue, newValue, passed_loc, this);
-        itr.first->second = nextValue;
+        prev_values.at(prev_position).second = nextValue;
 
     } else {
-        itr.first->second = newValue;
+        prev_values.at(prev_position).second = newValue;
     }
 
 }
@@ -0,0 +1,104 @@
+// Copyright (c) Chemical Language Foundation 2025.
+
+#include "ast/base/ASTAllocator.h"
+#include "utils/Benchmark.h"
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+/**
+ * measures the ast allocator, allocations go through allocate_with_cleanup so
+ * objects don't need to be ASTAny, the cleanup function is run at clear
+ */
+
+static void noop_cleanup(void*) {}
+
+static constexpr std::size_t BATCH_SIZE = 10000;
+static constexpr std::size_t OBJ_SIZE = 48;
+
+static void allocate_many(ASTAllocator& allocator, std::size_t count) {
+    for(std::size_t i = 0; i < count; ++i) {
+        allocator.allocate_with_cleanup(OBJ_SIZE, alignof(void*), (void*) noop_cleanup);
+    }
+}
+
+static void report(const char* name, std::size_t allocations, BenchmarkResults& results) {
+    const auto nanos = results.end_time - results.start_time;
+    std::cout << name << ' ' << results.representation();
+    std::cout << " [ns/alloc:" << (allocations ? nanos / allocations : 0) << ']' << std::endl;
+}
+
+/**
+ * a single thread allocating into a single allocator, cleared every round
+ */
+static void bench_single_thread(std::size_t count, unsigned rounds) {
+    ASTAllocator allocator(BATCH_SIZE);
+    BenchmarkResults results{};
+    results.benchmark_begin();
+    for(unsigned r = 0; r < rounds; ++r) {
+        allocate_many(allocator, count);
+        allocator.clear();
+    }
+    results.benchmark_end();
+    report("single_thread", count * rounds, results);
+}
+
+/**
+ * multiple threads allocating into a single shared allocator
+ */
+static void bench_shared(std::size_t count, unsigned rounds, unsigned threads) {
+    ASTAllocator allocator(BATCH_SIZE);
+    BenchmarkResults results{};
+    results.benchmark_begin();
+    for(unsigned r = 0; r < rounds; ++r) {
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for(unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&allocator, count, threads] {
+                allocate_many(allocator, count / threads);
+            });
+        }
+        for(auto& worker : workers) {
+            worker.join();
+        }
+        allocator.clear();
+    }
+    results.benchmark_end();
+    report("shared_allocator", count * rounds, results);
+}
+
+/**
+ * a single thread alternating between more allocators than the thread
+ * local arena cache holds, so every switch misses the cache
+ */
+static void bench_alternating(std::size_t count, unsigned rounds, unsigned allocators_count) {
+    std::vector<ASTAllocator> allocators;
+    allocators.reserve(allocators_count);
+    for(unsigned i = 0; i < allocators_count; ++i) {
+        allocators.emplace_back(BATCH_SIZE);
+    }
+    BenchmarkResults results{};
+    results.benchmark_begin();
+    for(unsigned r = 0; r < rounds; ++r) {
+        for(std::size_t i = 0; i < count; ++i) {
+            allocators[i % allocators_count].allocate_with_cleanup(OBJ_SIZE, alignof(void*), (void*) noop_cleanup);
+        }
+        for(auto& allocator : allocators) {
+            allocator.clear();
+        }
+    }
+    results.benchmark_end();
+    report("alternating_allocators", count * rounds, results);
+}
+
+int main(int argc, char** argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const unsigned rounds = argc > 2 ? (unsigned) std::strtoul(argv[2], nullptr, 10) : 10;
+    const unsigned hardware = std::thread::hardware_concurrency();
+    const unsigned threads = hardware > 1 ? hardware : 2;
+    bench_single_thread(count, rounds);
+    bench_shared(count, rounds, threads);
+    bench_alternating(count, rounds, 8);
+    return 0;
+}
@@ -0,0 +1,97 @@
+// Copyright (c) Chemical Language Foundation 2025.
+
+#include "ast/base/ASTAllocator.h"
+#include "preprocess/2c/2cASTVisitor.h"
+#include "utils/Benchmark.h"
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+/**
+ * measures how the c translation names temporaries and keeps them in its side maps
+ * (local_allocated, aliases), every round is a file, after which the maps are reset
+ * the keys are fake pointers, only the hashing matters
+ */
+
+static constexpr std::string_view PREFIX = "__chx__lv__";
+
+static void report(const char* name, std::size_t names, BenchmarkResults& results) {
+    const auto nanos = results.end_time - results.start_time;
+    std::cout << name << ' ' << results.representation();
+    std::cout << " [ns/name:" << (names ? nanos / names : 0) << ']' << std::endl;
+}
+
+/**
+ * same as ToCAstVisitor::get_local_temp_var_name
+ */
+static TempVarName temp_var_name(unsigned int& counter) {
+    TempVarName name;
+    std::memcpy(name.buffer, PREFIX.data(), PREFIX.size());
+    const auto end = sizeof(name.buffer) / sizeof(char);
+    const auto result = std::to_chars(name.buffer + PREFIX.size(), name.buffer + end, counter++);
+    name.length = static_cast<unsigned>(result.ptr - name.buffer);
+    return name;
+}
+
+/**
+ * a std::string is created for every name, the maps own a copy of it
+ */
+static void bench_string_names(std::size_t count, unsigned rounds, unsigned stored_every) {
+    std::unordered_map<void*, std::string> stored;
+    std::size_t total = 0;
+    BenchmarkResults results{};
+    results.benchmark_begin();
+    for(unsigned r = 0; r < rounds; ++r) {
+        unsigned int counter = 0;
+        for(std::size_t i = 0; i < count; ++i) {
+            auto name = std::string(PREFIX) + std::to_string(counter++);
+            total += name.size();
+            if(i % stored_every == 0) {
+                stored[(void*) (i * 16 + 16)] = name;
+            }
+        }
+        stored.clear();
+    }
+    results.benchmark_end();
+    report("string_names", count * rounds, results);
+    if(total == 0) std::cout << total;
+}
+
+/**
+ * names are formatted inline, the maps keep views of copies made in the visitor's names allocator
+ */
+static void bench_temp_var_names(std::size_t count, unsigned rounds, unsigned stored_every) {
+    ASTAllocator names_allocator(10000);
+    std::unordered_map<void*, chem::string_view> stored;
+    std::size_t total = 0;
+    BenchmarkResults results{};
+    results.benchmark_begin();
+    for(unsigned r = 0; r < rounds; ++r) {
+        unsigned int counter = 0;
+        for(std::size_t i = 0; i < count; ++i) {
+            const auto name = temp_var_name(counter);
+            total += name.length;
+            if(i % stored_every == 0) {
+                stored[(void*) (i * 16 + 16)] = chem::string_view(names_allocator.allocate_str(name.buffer, name.length), name.length);
+            }
+        }
+        stored.clear();
+        names_allocator.clear();
+    }
+    results.benchmark_end();
+    report("temp_var_names", count * rounds, results);
+    if(total == 0) std::cout << total;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    const unsigned rounds = argc > 2 ? (unsigned) std::strtoul(argv[2], nullptr, 10) : 100;
+    // most temporaries are only written, a few are kept in the side maps
+    const unsigned stored_every = 4;
+    bench_string_names(count, rounds, stored_every);
+    bench_temp_var_names(count, rounds, stored_every);
+    return 0;
+}
@@ -0,0 +1,177 @@
+// Copyright (c) Chemical Language Foundation 2026.
+
+#include "compiler/symres/ImplementationsIndex.h"
+#include "utils/Benchmark.h"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * measures lookups in the implementations index when many threads look up at once, like the
+ * operator and interface impl queries of parallel body linking, the same lookups are run on the
+ * shared mutex guarded unordered map (which the index replaced) for comparison
+ * keys are fake pointers (the index never dereferences them), get_impl only switches on the
+ * interface kind before calling get, so get is what's measured
+ */
+
+/**
+ * the index before it was made lock free, with its hash
+ */
+class SharedMutexIndex {
+public:
+
+    struct KeyHash {
+        std::size_t operator()(const ImplementationIndexKey& k) const {
+            const auto h1 = std::hash<const void*>{}((void*) k.interface);
+            const auto h2 = std::hash<const void*>{}((void*) k.for_);
+            return h1 ^ (h2 << 1);
+        }
+    };
+
+    std::unordered_map<ImplementationIndexKey, ImplDefinition*, KeyHash> map_;
+
+    mutable std::shared_mutex index_mutex;
+
+    void add(ASTNode* interface, ASTAny* for_, ImplDefinition* impl) {
+        std::unique_lock lock(index_mutex);
+        map_.emplace(ImplementationIndexKey{ interface, for_ }, impl);
+    }
+
+    ImplDefinition* get(ASTNode* interface, ASTAny* for_) const {
+        std::shared_lock lock(index_mutex);
+        const auto it = map_.find(ImplementationIndexKey{ interface, for_ });
+        if(it == map_.end()) return nullptr;
+        return it->second;
+    }
+
+};
+
+/**
+ * misses are looked up for these many interfaces and types
+ */
+static constexpr std::size_t MISS_INTERFACES = 8;
+static constexpr std::size_t MISS_TYPES = 16;
+
+/**
+ * fake aligned pointers, allocated close to each other like ast nodes
+ */
+template<typename T>
+static inline T* fake_ptr(std::size_t index) {
+    return reinterpret_cast<T*>(static_cast<std::uintptr_t>(0x10000 + index * 64));
+}
+
+static void report(const char* index_name, const char* name, unsigned threads, std::size_t lookups, BenchmarkResults& results, double single_thread_rate) {
+    const auto nanos = results.end_time - results.start_time;
+    const auto rate = nanos ? (double) lookups / (double) nanos : 0.0;
+    std::cout << index_name << ' ' << name << " threads:" << threads << ' ' << results.representation();
+    std::cout << " [ns/lookup:" << (lookups ? (double) nanos * threads / (double) lookups : 0.0) << ']';
+    std::cout << " [scaling:" << (single_thread_rate > 0 ? rate / single_thread_rate : 1.0) << ']' << std::endl;
+}
+
+/**
+ * every thread does the given lookups, `interfaces` interfaces are implemented for `types` types
+ * a lookup of a type beyond the implemented types misses, one in `miss_every` lookups is a miss
+ * misses repeat for a few interfaces and types (an operator used on the same types again and again)
+ * returns the lookups per nanosecond
+ */
+template<typename Index>
+static double bench_lookups(const char* index_name, const char* name, Index& index, std::size_t interfaces, std::size_t types, unsigned threads, std::size_t per_thread, std::size_t miss_every, double single_thread_rate) {
+    std::atomic<unsigned> ready = 0;
+    std::atomic<bool> start = false;
+    std::atomic<std::size_t> found = 0;
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for(unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            std::size_t local_found = 0;
+            // every thread walks the keys in a different order
+            std::size_t state = t * 0x9E3779B97F4A7C15ULL + 1;
+            ready.fetch_add(1, std::memory_order_acq_rel);
+            while(!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for(std::size_t i = 0; i < per_thread; ++i) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                auto interface = (state >> 33) % interfaces;
+                auto type = (state >> 13) % types;
+                if(miss_every && i % miss_every == 0) {
+                    interface %= MISS_INTERFACES;
+                    type = types + type % MISS_TYPES;
+                }
+                if(index.get(fake_ptr<ASTNode>(interface), fake_ptr<ASTAny>(interfaces + type)) != nullptr) {
+                    local_found++;
+                }
+            }
+            found.fetch_add(local_found, std::memory_order_relaxed);
+        });
+    }
+    while(ready.load(std::memory_order_acquire) != threads) {
+        std::this_thread::yield();
+    }
+    BenchmarkResults results{};
+    results.benchmark_begin();
+    start.store(true, std::memory_order_release);
+    for(auto& worker : workers) {
+        worker.join();
+    }
+    results.benchmark_end();
+    const auto lookups = per_thread * threads;
+    report(index_name, name, threads, lookups, results, single_thread_rate);
+    const auto expected = miss_every ? lookups - threads * ((per_thread + miss_every - 1) / miss_every) : lookups;
+    if(found.load() != expected) {
+        std::cout << "unexpected number of found implementations " << found.load() << ", expected " << expected << std::endl;
+    }
+    const auto nanos = results.end_time - results.start_time;
+    return nanos ? (double) lookups / (double) nanos : 0.0;
+}
+
+template<typename Index>
+static void fill(Index& index, std::size_t interfaces, std::size_t types) {
+    for(std::size_t i = 0; i < interfaces; ++i) {
+        for(std::size_t t = 0; t < types; ++t) {
+            index.add(fake_ptr<ASTNode>(i), fake_ptr<ASTAny>(interfaces + t), fake_ptr<ImplDefinition>(i * types + t + 1));
+        }
+    }
+}
+
+/**
+ * runs the lookups on 1, 2, 4... up to max threads, the scaling is the rate of lookups relative to a single thread
+ */
+template<typename Index>
+static void bench_scaling(const char* index_name, Index& index, std::size_t interfaces, std::size_t types, unsigned max_threads, std::size_t per_thread) {
+    const char* names[] = { "hits", "misses", "mixed" };
+    const std::size_t miss_every[] = { 0, 1, 4 };
+    for(unsigned n = 0; n < 3; ++n) {
+        double single_thread_rate = 0;
+        for(unsigned threads = 1; threads <= max_threads; threads *= 2) {
+            const auto rate = bench_lookups(index_name, names[n], index, interfaces, types, threads, per_thread, miss_every[n], single_thread_rate);
+            if(threads == 1) {
+                single_thread_rate = rate;
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::size_t per_thread = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    const unsigned max_threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 32;
+    // about as many implementations as a project with the standard library indexes
+    const std::size_t interfaces = 64;
+    const std::size_t types = 64;
+    std::cout << "lookups per thread: " << per_thread << " max threads: " << max_threads << " cores: " << std::thread::hardware_concurrency() << std::endl;
+    {
+        SharedMutexIndex index;
+        fill(index, interfaces, types);
+        bench_scaling("shared_mutex", index, interfaces, types, max_threads, per_thread);
+    }
+    {
+        ImplementationsIndex index;
+        fill(index, interfaces, types);
+        bench_scaling("lock_free", index, interfaces, types, max_threads, per_thread);
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+// Copyright (c) Chemical Language Foundation 2025.
+
+#include "ast/base/InterpretScope.h"
+#include "utils/Benchmark.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * measures the values map of interpret scopes against the unordered map it replaced, in the pattern
+ * of a loop heavy comptime function, every iteration creates a block scope, declares a few locals, looks
+ * them (and the function's locals) up many times and erases them when the block ends
+ * values are fake pointers, only the map operations are measured
+ */
+
+using unordered_value_map = std::unordered_map<chem::string_view, Value*>;
+
+static const chem::string_view FUNCTION_LOCALS[] = { "i", "sum", "count", "result" };
+static const chem::string_view BLOCK_LOCALS[] = { "x", "y", "tmp" };
+
+static void report(const char* name, std::size_t operations, BenchmarkResults& results) {
+    const auto nanos = results.end_time - results.start_time;
+    std::cout << name << ' ' << results.representation();
+    std::cout << " [ns/op:" << (operations ? (double) nanos / (double) operations : 0.0) << ']' << std::endl;
+}
+
+template<typename Map>
+static inline Value* lookup(Map& map, const chem::string_view& name) {
+    auto found = map.find(name);
+    return found != map.end() ? found->second : nullptr;
+}
+
+/**
+ * a loop of given iterations in a function scope, the block scope of the loop body is created every iteration
+ * every iteration reads and writes the block's and the function's locals, like `x = i * 2; sum = sum + x`
+ */
+template<typename Map>
+static void bench_loop(const char* name, std::size_t iterations, unsigned rounds) {
+    std::size_t checksum = 0;
+    std::size_t operations = 0;
+    BenchmarkResults results{};
+    results.benchmark_begin();
+    for(unsigned r = 0; r < rounds; ++r) {
+        Map function_scope;
+        for(const auto& local : FUNCTION_LOCALS) {
+            function_scope[local] = (Value*) &local;
+        }
+        for(std::size_t i = 0; i < iterations; ++i) {
+            Map block_scope;
+            for(const auto& local : BLOCK_LOCALS) {
+                block_scope[local] = (Value*) &local;
+            }
+            // the body reads locals of both scopes, looking in the block first
+            for(unsigned access = 0; access < 4; ++access) {
+                for(const auto& local : FUNCTION_LOCALS) {
+                    auto value = lookup(block_scope, local);
+                    if(!value) value = lookup(function_scope, local);
+                    checksum += (std::size_t) value;
+                }
+                for(const auto& local : BLOCK_LOCALS) {
+                    checksum += (std::size_t) lookup(block_scope, local);
+                }
+            }
+            // assignments to the function's locals
+            function_scope[FUNCTION_LOCALS[1]] = (Value*) (i + 1);
+            function_scope[FUNCTION_LOCALS[0]] = (Value*) (i + 2);
+            // the temporary is erased before the block ends
+            block_scope.erase(BLOCK_LOCALS[2]);
+            operations += 3 + 4 * 7 + 2 + 1;
+        }
+    }
+    results.benchmark_end();
+    report(name, operations, results);
+    if(checksum == 0) std::cout << checksum;
+}
+
+/**
+ * the global scope holds many values (above the index threshold), they are looked up by name
+ */
+template<typename Map>
+static void bench_global(const char* name, std::vector<std::string>& names, std::size_t lookups, unsigned rounds) {
+    std::size_t checksum = 0;
+    BenchmarkResults results{};
+    results.benchmark_begin();
+    for(unsigned r = 0; r < rounds; ++r) {
+        Map global_scope;
+        for(auto& str : names) {
+            global_scope[chem::string_view(str.data(), str.size())] = (Value*) &str;
+        }
+        for(std::size_t i = 0; i < lookups; ++i) {
+            auto& str = names[(i * 7) % names.size()];
+            checksum += (std::size_t) lookup(global_scope, chem::string_view(str.data(), str.size()));
+        }
+    }
+    results.benchmark_end();
+    report(name, (names.size() + lookups) * rounds, results);
+    if(checksum == 0) std::cout << checksum;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    const unsigned rounds = argc > 2 ? (unsigned) std::strtoul(argv[2], nullptr, 10) : 20;
+    bench_loop<unordered_value_map>("loop_unordered_map", iterations, rounds);
+    bench_loop<InterpretValueMap>("loop_value_map", iterations, rounds);
+    std::vector<std::string> names;
+    for(unsigned i = 0; i < 200; ++i) {
+        names.emplace_back("global_value_" + std::to_string(i));
+    }
+    bench_global<unordered_value_map>("global_unordered_map", names, iterations, rounds);
+    bench_global<InterpretValueMap>("global_value_map", names, iterations, rounds);
+    return 0;
+}
@@ -0,0 +1,80 @@
+// Copyright (c) Chemical Language Foundation 2025.
+
+#include "lexer/Lexer.h"
+#include "ast/base/BatchAllocator.h"
+#include "utils/Benchmark.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * measures the lexer throughput in MB/s on the chemical sources in a directory (lang/libs by default)
+ * the files are read into memory first, so only the lexing is measured, cbi is disabled (no binder)
+ */
+
+struct SourceFile {
+    std::string path;
+    std::string contents;
+};
+
+static std::vector<SourceFile> read_sources(const std::filesystem::path& dir) {
+    std::vector<SourceFile> files;
+    for(auto& entry : std::filesystem::recursive_directory_iterator(dir)) {
+        if(!entry.is_regular_file() || entry.path().extension() != ".ch") continue;
+        std::ifstream stream(entry.path(), std::ios::binary);
+        std::stringstream buffer;
+        buffer << stream.rdbuf();
+        files.push_back({ entry.path().string(), buffer.str() });
+    }
+    return files;
+}
+
+static void report(const char* name, std::size_t bytes, std::size_t tokens, BenchmarkResults& results) {
+    const auto nanos = results.end_time - results.start_time;
+    const auto mb_per_sec = nanos ? ((double) bytes / (1024.0 * 1024.0)) / ((double) nanos / 1e9) : 0.0;
+    std::cout << name << ' ' << results.representation();
+    std::cout << " [MB/s:" << mb_per_sec << "] [ns/token:" << (tokens ? nanos / tokens : 0) << ']' << std::endl;
+}
+
+/**
+ * lexes every file into a token vector, the way the ast processor does
+ */
+static void bench_lex_files(std::vector<SourceFile>& files, unsigned rounds) {
+    BatchAllocator file_allocator(10000);
+    std::vector<Token> tokens;
+    std::size_t bytes = 0;
+    std::size_t total_tokens = 0;
+    BenchmarkResults results{};
+    results.benchmark_begin();
+    for(unsigned r = 0; r < rounds; ++r) {
+        for(auto& file : files) {
+            InputSource input(file.contents.data(), file.contents.size());
+            Lexer lexer(file.path, input, nullptr, file_allocator);
+            tokens.clear();
+            lexer.getTokens(tokens);
+            bytes += file.contents.size();
+            total_tokens += tokens.size();
+        }
+    }
+    results.benchmark_end();
+    report("lex_files", bytes, total_tokens, results);
+}
+
+int main(int argc, char** argv) {
+    const std::filesystem::path dir = argc > 1 ? argv[1] : "lang/libs";
+    const unsigned rounds = argc > 2 ? (unsigned) std::strtoul(argv[2], nullptr, 10) : 20;
+    auto files = read_sources(dir);
+    if(files.empty()) {
+        std::cerr << "no chemical sources found in " << dir.string() << std::endl;
+        return 1;
+    }
+    std::size_t bytes = 0;
+    for(auto& file : files) bytes += file.contents.size();
+    std::cout << "files:" << files.size() << " bytes:" << bytes << std::endl;
+    bench_lex_files(files, rounds);
+    return 0;
+}
@@ -0,0 +1,147 @@
+// Copyright (c) Chemical Language Foundation 2025.
+
+#include "lexer/Lexer.h"
+#include "ast/base/BatchAllocator.h"
+#include "utils/Benchmark.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * measures the memory and time of materializing the token vector for every chemical source
+ * in a directory (lang/libs by default), every file is lexed into a fresh vector like the ast processor does
+ * the vector is either grown on demand or reserved from the file size with different bytes per token
+ */
+
+struct SourceFile {
+    std::string path;
+    std::string contents;
+};
+
+static std::vector<SourceFile> read_sources(const std::filesystem::path& dir) {
+    std::vector<SourceFile> files;
+    for(auto& entry : std::filesystem::recursive_directory_iterator(dir)) {
+        if(!entry.is_regular_file() || entry.path().extension() != ".ch") continue;
+        std::ifstream stream(entry.path(), std::ios::binary);
+        std::stringstream buffer;
+        buffer << stream.rdbuf();
+        files.push_back({ entry.path().string(), buffer.str() });
+    }
+    return files;
+}
+
+struct BufferStats {
+    // sum of the final capacities in bytes
+    std::size_t capacity_bytes = 0;
+    // sum of the tokens in bytes
+    std::size_t used_bytes = 0;
+    // largest capacity (in bytes) of a single file
+    std::size_t peak_bytes = 0;
+    // number of times a vector was reallocated
+    std::size_t regrowths = 0;
+    // number of files that had to regrow at least once
+    std::size_t regrown_files = 0;
+};
+
+/**
+ * lexes the file with the given reserve, zero bytes per token means no reserve
+ */
+static void lex_file(SourceFile& file, BatchAllocator& allocator, std::size_t bytes_per_token, BufferStats& stats) {
+    InputSource input(file.contents.data(), file.contents.size());
+    Lexer lexer(file.path, input, nullptr, allocator);
+    std::vector<Token> tokens;
+    if(bytes_per_token != 0) {
+        tokens.reserve(file.contents.size() / bytes_per_token + 1);
+    }
+    auto capacity = tokens.capacity();
+    std::size_t regrowths = 0;
+    while(true) {
+        auto token = lexer.getNextToken();
+        tokens.emplace_back(token);
+        if(tokens.capacity() != capacity) {
+            capacity = tokens.capacity();
+            regrowths++;
+        }
+        if(token.type == TokenType::EndOfFile || token.type == TokenType::Unexpected) {
+            break;
+        }
+    }
+    const auto capacity_bytes = tokens.capacity() * sizeof(Token);
+    stats.capacity_bytes += capacity_bytes;
+    stats.used_bytes += tokens.size() * sizeof(Token);
+    stats.peak_bytes = std::max(stats.peak_bytes, capacity_bytes);
+    stats.regrowths += regrowths;
+    if(bytes_per_token != 0 ? regrowths != 0 : regrowths > 1) {
+        stats.regrown_files++;
+    }
+}
+
+static void bench_reserve(std::vector<SourceFile>& files, std::size_t bytes_per_token, unsigned rounds) {
+    BatchAllocator allocator(10000);
+    BufferStats stats;
+    BenchmarkResults results{};
+    results.benchmark_begin();
+    for(unsigned r = 0; r < rounds; ++r) {
+        stats = BufferStats();
+        for(auto& file : files) {
+            lex_file(file, allocator, bytes_per_token, stats);
+        }
+    }
+    results.benchmark_end();
+    const auto nanos = results.end_time - results.start_time;
+    std::cout << "reserve ";
+    if(bytes_per_token == 0) {
+        std::cout << "none";
+    } else {
+        std::cout << "size/" << bytes_per_token;
+    }
+    std::cout << ' ' << results.representation() << " [ms/round:" << (nanos / rounds) / 1000000.0 << ']';
+    std::cout << " [capacity KB:" << stats.capacity_bytes / 1024 << "] [used KB:" << stats.used_bytes / 1024 << ']';
+    std::cout << " [peak file KB:" << stats.peak_bytes / 1024 << "] [regrowths:" << stats.regrowths << ']';
+    std::cout << " [files regrown:" << stats.regrown_files << ']' << std::endl;
+}
+
+/**
+ * prints the distribution of bytes per token over the files
+ */
+static void print_bytes_per_token(std::vector<SourceFile>& files) {
+    BatchAllocator allocator(10000);
+    std::vector<double> ratios;
+    std::size_t bytes = 0;
+    std::size_t total_tokens = 0;
+    for(auto& file : files) {
+        InputSource input(file.contents.data(), file.contents.size());
+        Lexer lexer(file.path, input, nullptr, allocator);
+        std::vector<Token> tokens;
+        lexer.getTokens(tokens);
+        bytes += file.contents.size();
+        total_tokens += tokens.size();
+        ratios.push_back((double) file.contents.size() / (double) tokens.size());
+    }
+    std::sort(ratios.begin(), ratios.end());
+    const auto at = [&ratios](double q) { return ratios[(std::size_t) (q * (double) (ratios.size() - 1))]; };
+    std::cout << "files:" << files.size() << " bytes:" << bytes << " tokens:" << total_tokens << " sizeof(Token):" << sizeof(Token) << std::endl;
+    std::cout << "bytes/token overall:" << (double) bytes / (double) total_tokens << " min:" << ratios.front();
+    std::cout << " p10:" << at(0.1) << " median:" << at(0.5) << " p90:" << at(0.9) << " max:" << ratios.back() << std::endl;
+}
+
+int main(int argc, char** argv) {
+    const std::filesystem::path dir = argc > 1 ? argv[1] : "lang/libs";
+    const unsigned rounds = argc > 2 ? (unsigned) std::strtoul(argv[2], nullptr, 10) : 10;
+    auto files = read_sources(dir);
+    if(files.empty()) {
+        std::cerr << "no chemical sources found in " << dir.string() << std::endl;
+        return 1;
+    }
+    print_bytes_per_token(files);
+    bench_reserve(files, 0, rounds);
+    for(const std::size_t bytes_per_token : { 2, 3, 4, 5, 6, 8 }) {
+        bench_reserve(files, bytes_per_token, rounds);
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+// Copyright (c) Chemical Language Foundation 2025.
+
+#include "utils/WorkStealingPool.h"
+#include "utils/Benchmark.h"
+#include "ctpl.h"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+/**
+ * measures the work stealing pool under contention, many tiny tasks are pushed so the
+ * time is dominated by queueing, the same workloads are run on ctpl::thread_pool (which
+ * the pool replaced) for comparison
+ */
+
+static std::atomic<std::uint64_t> sink = 0;
+
+static void tiny_work(int id) {
+    sink.fetch_add(static_cast<std::uint64_t>(id + 1), std::memory_order_relaxed);
+}
+
+static void report(const char* pool_name, const char* name, std::size_t tasks, BenchmarkResults& results) {
+    const auto nanos = results.end_time - results.start_time;
+    std::cout << pool_name << ' ' << name << ' ' << results.representation();
+    std::cout << " [ns/task:" << (tasks ? nanos / tasks : 0) << ']' << std::endl;
+}
+
+/**
+ * every task is pushed from the main thread, all threads contend on the queue
+ */
+template<typename Pool>
+static void bench_external_push(const char* pool_name, Pool& pool, std::size_t count) {
+    std::vector<std::future<void>> futures;
+    futures.reserve(count);
+    BenchmarkResults results{};
+    results.benchmark_begin();
+    for(std::size_t i = 0; i < count; ++i) {
+        futures.emplace_back(pool.push(tiny_work));
+    }
+    for(auto& future : futures) {
+        future.get();
+    }
+    results.benchmark_end();
+    report(pool_name, "external_push", count, results);
+}
+
+/**
+ * a task per worker pushes the tasks, like files pushing work for their nodes, producers
+ * don't wait for the tasks they push (that would block every thread of ctpl::thread_pool)
+ */
+template<typename Pool>
+static void bench_nested_push(const char* pool_name, Pool& pool, std::size_t count) {
+    const auto producers = static_cast<std::size_t>(pool.size());
+    const auto per_producer = count / producers;
+    std::atomic<std::size_t> remaining = per_producer * producers;
+    BenchmarkResults results{};
+    results.benchmark_begin();
+    for(std::size_t p = 0; p < producers; ++p) {
+        pool.push([&pool, &remaining, per_producer](int) {
+            for(std::size_t i = 0; i < per_producer; ++i) {
+                pool.push([&remaining](int id) {
+                    tiny_work(id);
+                    remaining.fetch_sub(1, std::memory_order_release);
+                });
+            }
+        });
+    }
+    while(remaining.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+    results.benchmark_end();
+    report(pool_name, "nested_push", per_producer * producers, results);
+}
+
+/**
+ * fork / join with a task group, the waiting thread runs the group's tasks too
+ */
+static void bench_task_group(WorkStealingPool& pool, std::size_t count) {
+    BenchmarkResults results{};
+    results.benchmark_begin();
+    TaskGroup group(pool);
+    for(std::size_t i = 0; i < count; ++i) {
+        group.run(tiny_work);
+    }
+    group.wait();
+    results.benchmark_end();
+    report("work_stealing", "task_group", count, results);
+}
+
+int main(int argc, char** argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    const unsigned hardware = std::thread::hardware_concurrency();
+    const int threads = argc > 2 ? std::atoi(argv[2]) : static_cast<int>(hardware > 1 ? hardware : 2);
+    std::cout << "tasks: " << count << " threads: " << threads << std::endl;
+    {
+        ctpl::thread_pool pool(threads);
+        bench_external_push("ctpl", pool, count);
+        bench_nested_push("ctpl", pool, count);
+    }
+    {
+        WorkStealingPool pool(threads);
+        bench_external_push("work_stealing", pool, count);
+        bench_nested_push("work_stealing", pool, count);
+        bench_task_group(pool, count);
+    }
+    return 0;
+}
@@ -8,6 +8,7 @@
 #include "compiler/typeverify/TypeVerifyAPI.h"
 #include "preprocess/2c/2cASTVisitor.h"
 #include "utils/Benchmark.h"
+#include "utils/WorkStealingPool.h"
 #include <sstream>
 #include "utils/PathUtils.h"
 #include "compiler/lab/LabBuildCompiler.h"
@@ -19,9 +20,11 @@
 #include "ast/statements/VarInit.h"
 #include <filesystem>
 #include <random>
+#include <atomic>
 
 #include "lexer/Lexer.h"
 #include "stream/FileInputSource.h"
+#include "utils/ContentHash.h"
 #include "ast/base/GlobalInterpretScope.h"
 #include "preprocess/ImportPathHandler.h"
 #include "compiler/lab/mod_conv/ModToLabConverter.h"
@@ -206,7 +209,7 @@ void ASTProcessor::determine_module_files(
 }
 
 bool ASTProcessor::import_module_files_direct(
-        ctpl::thread_pool& pool,
+        WorkStealingPool& pool,
         std::vector<ASTFileMetaData>& files,
         LabModule* module
 ) {
@@ -387,10 +390,9 @@ void ASTProcessor::sym_res_declare_and_link_file(Scope& scope, unsigned int file
 
 inline static void declareAllSymbols(SymbolResolver& resolver, ChildrenMapNode* children) {
     // user didn't give any alias or symbols
-    // declare everything
-    for (auto& sym: children->symbols) {
-        resolver.declare_or_shadow(sym.first, sym.second);
-    }
+    // declare everything, the exported symbols are built into a layer once
+    // and shared by all the modules that depend on this module
+    resolver.declare_layer(children->get_layer());
 }
 
 static void declareChildren(SymbolResolver& resolver, ModuleDependency& dep, ChildrenMapNode* children) {
@@ -423,11 +425,113 @@ static SymResLinkBodyResult link_body_generic_decls_task(SymbolResolver* resolve
     return sym_res_link_body_generic_decls_pass(*resolver, &file->unit.scope.body, file->private_symbol_range);
 }
 
-static SymResLinkBodyResult link_body_task(SymbolResolver* resolver, ASTFileResult* file) {
-    return sym_res_link_body_pass(*resolver, &file->unit.scope.body, file->private_symbol_range);
+struct TypeVerifyFileResult {
+    bool has_errors = false;
+    std::vector<Diag> diagnostics;
+};
+
+TypeVerifyFileResult type_verify_nodes_task(
+    ASTProcessor* processor,
+    std::span<ASTNode*> nodes
+) {
+    TypeVerifyFileResult result;
+    // make a local diagnoser
+    ASTDiagnoser diagnoser(processor->loc_man);
+
+    // run verification
+    type_verify(processor->resolver->implsIndex, diagnoser, processor->file_allocator, nodes);
+
+    result.has_errors = diagnoser.has_errors();
+    result.diagnostics = std::move(diagnoser.diagnostics);
+    return result;
 }
 
-int ASTProcessor::sym_res_module(LabModule* module, ctpl::thread_pool& pool) {
+/**
+ * files with more top level nodes than this are linked and verified in batches of this size
+ */
+static constexpr std::size_t FILE_BATCH_NODES = 128;
+
+/**
+ * a batch of consecutive top level nodes in a file, large files are split in batches, so idle
+ * workers steal the remaining bodies of a large file, instead of a single worker processing it whole
+ */
+struct FileNodesBatch {
+    std::size_t file_index;
+    std::span<ASTNode*> nodes;
+};
+
+/**
+ * splits the top level nodes of the files into batches, in order of files and nodes
+ */
+static std::vector<FileNodesBatch> make_file_batches(std::vector<ASTFileMetaData>& files) {
+    std::vector<FileNodesBatch> batches;
+    batches.reserve(files.size());
+    for(std::size_t i = 0; i < files.size(); i++) {
+        std::span<ASTNode*> nodes = files[i].result->unit.scope.body.nodes;
+        if(nodes.size() <= FILE_BATCH_NODES) {
+            batches.push_back(FileNodesBatch{ i, nodes });
+            continue;
+        }
+        for(std::size_t start = 0; start < nodes.size(); start += FILE_BATCH_NODES) {
+            batches.push_back(FileNodesBatch{ i, nodes.subspan(start, std::min(FILE_BATCH_NODES, nodes.size() - start)) });
+        }
+    }
+    return batches;
+}
+
+/**
+ * prints the type verification diagnostics of the batches, returns false if any batch had errors
+ * batches are in source order, so diagnostics are printed as if files were verified whole
+ */
+static bool report_type_verify_results(LabModule* module, const std::vector<FileNodesBatch>& batches, std::vector<TypeVerifyFileResult>& results) {
+    bool success = true;
+    for(std::size_t i = 0; i < results.size(); i++) {
+        auto& res = results[i];
+        if(res.has_errors) {
+            success = false;
+        }
+        if(!res.diagnostics.empty()) {
+            Diagnoser::print_diagnostics(res.diagnostics, chem::string_view(module->direct_files[batches[i].file_index].abs_path), "TypeCheck");
+        }
+    }
+    return success;
+}
+
+/**
+ * runs the task for every direct file of the module in a task group, the calling thread
+ * runs tasks too while it waits, returns whether each file had errors (in order of files)
+ */
+template<typename FileTask>
+static std::vector<char> run_file_tasks(WorkStealingPool& pool, LabModule* module, FileTask task) {
+    auto& files = module->direct_files;
+    std::vector<char> has_errors(files.size(), false);
+    TaskGroup group(pool);
+    for(std::size_t i = 0; i < files.size(); i++) {
+        group.run([&task, &has_errors, &file = *files[i].result, i](int id) {
+            has_errors[i] = task(file);
+        });
+    }
+    group.wait();
+    return has_errors;
+}
+
+/**
+ * prints the time taken by a parallel phase of symbol resolution in the module
+ */
+static void print_phase_benchmark(LabModule* module, const std::string_view& phase, BenchmarkResults& bm) {
+    bm.benchmark_end();
+    std::cout << "[SymRes:" << phase << "] '" << *module << "' completed " << bm.representation() << std::endl;
+}
+
+/**
+ * timings of a file in the link body phase, used to find the critical path of the phase
+ */
+struct LinkBodyFileTimings {
+    BenchmarkResults link_body;
+    BenchmarkResults type_verify;
+};
+
+int ASTProcessor::sym_res_module(LabModule* module, WorkStealingPool& pool, bool type_verify) {
 
     const auto prev_mod_scope = resolver->current_mod_scope;
     resolver->current_mod_scope = &module->module_scope;
@@ -471,6 +575,10 @@ int ASTProcessor::sym_res_module(LabModule* module, ctpl::thread_pool& pool) {
     // tiny flag for checking error
     bool errored = false;
 
+    // benchmarking the parallel phases
+    const auto bm = options->benchmark_modules;
+    BenchmarkResults phase_bm;
+
     // declare symbols for all files once in the module
     for(auto& file_ptr : module->direct_files) {
 
@@ -492,31 +600,25 @@ int ASTProcessor::sym_res_module(LabModule* module, ctpl::thread_pool& pool) {
 
     if(errored) return 1;
 
-    std::vector<std::future<bool>> futures;
-    futures.reserve(module->direct_files.size());
-
     // link the signature of the files in parallel
-    for(auto& file_ptr : module->direct_files) {
-        auto& file = *file_ptr.result;
-        futures.emplace_back(pool.push([this, &file](int id){
-            auto res = link_sig_file_task(resolver, &file);
-            if(!res.diagnostics.empty()) {
-                std::lock_guard<std::mutex> guard(print_mutex);
-                Diagnoser::print_diagnostics(res.diagnostics, chem::string_view(file.abs_path), "SymRes:link_sig");
-            }
-            auto has_errors = res.has_errors;
-            file.sig_result = std::move(res);
-            return has_errors;
-        }));
-    }
-    for(auto& f : futures) {
-        auto has_errors = f.get();
+    if(bm) phase_bm.benchmark_begin();
+    auto errors = run_file_tasks(pool, module, [this](ASTFileResult& file) {
+        auto res = link_sig_file_task(resolver, &file);
+        if(!res.diagnostics.empty()) {
+            std::lock_guard<std::mutex> guard(print_mutex);
+            Diagnoser::print_diagnostics(res.diagnostics, chem::string_view(file.abs_path), "SymRes:link_sig");
+        }
+        auto has_errors = res.has_errors;
+        file.sig_result = std::move(res);
+        return has_errors;
+    });
+    if(bm) print_phase_benchmark(module, "link_sig", phase_bm);
+    for(const auto has_errors : errors) {
         if(has_errors) {
             if(options->stop_on_file_error) return 1;
             errored = true;
         }
     }
-    futures.clear();
 
     // clear everything allocated during link signature pass
     file_allocator.clear();
@@ -530,25 +632,22 @@ int ASTProcessor::sym_res_module(LabModule* module, ctpl::thread_pool& pool) {
     generate_automatic_functions_for_module(module, *resolver->ast_allocator, *resolver->mod_allocator, *resolver);
 
     // generic instantiation pass in parallel
-    for(auto& file_ptr : module->direct_files) {
-        auto& file = *file_ptr.result;
-        futures.emplace_back(pool.push([this, &file](int id){
-            auto res = gen_inst_file_task(resolver, &file);
-            if(!res.diagnostics.empty()) {
-                std::lock_guard<std::mutex> guard(print_mutex);
-                Diagnoser::print_diagnostics(res.diagnostics, chem::string_view(file.abs_path), "SymRes:gen_inst");
-            }
-            return res.has_errors;
-        }));
-    }
-    for(auto& f : futures) {
-        auto has_errors = f.get();
+    if(bm) phase_bm.benchmark_begin();
+    errors = run_file_tasks(pool, module, [this](ASTFileResult& file) {
+        auto res = gen_inst_file_task(resolver, &file);
+        if(!res.diagnostics.empty()) {
+            std::lock_guard<std::mutex> guard(print_mutex);
+            Diagnoser::print_diagnostics(res.diagnostics, chem::string_view(file.abs_path), "SymRes:gen_inst");
+        }
+        return res.has_errors;
+    });
+    if(bm) print_phase_benchmark(module, "gen_inst", phase_bm);
+    for(const auto has_errors : errors) {
         if(has_errors) {
             if(options->stop_on_file_error) return 1;
             errored = true;
         }
     }
-    futures.clear();
 
     // clear everything allocated during gen instantiator pass
     file_allocator.clear();
@@ -578,46 +677,99 @@ int ASTProcessor::sym_res_module(LabModule* module, ctpl::thread_pool& pool) {
     // Two-pass link body: pass 1 resolves generic declaration master bodies,
     // pass 2 does full link body (instantiate generics, resolve function bodies).
 
-    for(auto& file_ptr : module->direct_files) {
-        auto& file = *file_ptr.result;
-        futures.emplace_back(pool.push([this, &file](int id){
-            auto res = link_body_generic_decls_task(resolver, &file);
-            if(!res.diagnostics.empty()) {
-                std::lock_guard<std::mutex> guard(print_mutex);
-                Diagnoser::print_diagnostics(res.diagnostics, chem::string_view(file.abs_path), "SymRes:gen_inst");
-            }
-            return res.has_errors;
-        }));
-    }
-    for(auto& f : futures) {
-        auto has_errors = f.get();
+    if(bm) phase_bm.benchmark_begin();
+    errors = run_file_tasks(pool, module, [this](ASTFileResult& file) {
+        auto res = link_body_generic_decls_task(resolver, &file);
+        if(!res.diagnostics.empty()) {
+            std::lock_guard<std::mutex> guard(print_mutex);
+            Diagnoser::print_diagnostics(res.diagnostics, chem::string_view(file.abs_path), "SymRes:gen_inst");
+        }
+        return res.has_errors;
+    });
+    if(bm) print_phase_benchmark(module, "link_body_generic_decls", phase_bm);
+    for(const auto has_errors : errors) {
         if(has_errors) {
             if(options->stop_on_file_error) return 1;
             errored = true;
         }
     }
-    futures.clear();
 
-    // pass 2: full link body (parallel)
-    for(auto& file_ptr : module->direct_files) {
-        auto& file = *file_ptr.result;
-        futures.emplace_back(pool.push([this, &file](int id){
-            auto res = link_body_task(resolver, &file);
-            if(!res.diagnostics.empty()) {
-                std::lock_guard<std::mutex> guard(print_mutex);
-                Diagnoser::print_diagnostics(res.diagnostics, chem::string_view(file.abs_path), "SymRes:link");
+    // core nodes are linked after the bodies of the core module, verification reads them (e.g. the copy
+    // interface bits), so the core module is verified once all its bodies and core nodes are linked
+    const auto is_core_module = module->scope_name.empty() && module->name == "core";
+
+    // every other module verifies a batch in the same task right after its bodies are linked, verification
+    // reads the linked bodies of the batch and signatures of other nodes (linked in the previous passes)
+    const auto verify_batches = type_verify && !is_core_module;
+
+    // pass 2: full link body (parallel), large files are split into batches of nodes
+    auto& files = module->direct_files;
+    auto batches = make_file_batches(files);
+    std::vector<SymResLinkBodyResult> link_results(batches.size());
+    std::vector<TypeVerifyFileResult> verify_results(verify_batches ? batches.size() : 0);
+    std::vector<LinkBodyFileTimings> timings(bm ? batches.size() : 0);
+    // verification is skipped once any batch fails to link, its results would be discarded
+    std::atomic<bool> link_failed = false;
+    if(bm) phase_bm.benchmark_begin();
+    {
+        TaskGroup group(pool);
+        for(std::size_t i = 0; i < batches.size(); i++) {
+            group.run([this, &files, &batches, &link_results, &verify_results, &timings, &link_failed, verify_batches, bm, i](int) {
+                auto& batch = batches[i];
+                auto& file = *files[batch.file_index].result;
+                if(bm) timings[i].link_body.benchmark_begin();
+                // using statements in the nodes of the file before this batch are declared by the batch
+                auto& file_nodes = file.unit.scope.body.nodes;
+                const auto preceding = std::span<ASTNode*>(file_nodes.data(), static_cast<std::size_t>(batch.nodes.data() - file_nodes.data()));
+                auto& res = link_results[i];
+                res = sym_res_link_body_pass(*resolver, batch.nodes, preceding, file.private_symbol_range);
+                if(bm) timings[i].link_body.benchmark_end();
+                if(res.has_errors) {
+                    link_failed.store(true, std::memory_order_relaxed);
+                    return;
+                }
+                if(verify_batches && !link_failed.load(std::memory_order_relaxed)) {
+                    if(bm) timings[i].type_verify.benchmark_begin();
+                    verify_results[i] = type_verify_nodes_task(this, batch.nodes);
+                    if(bm) timings[i].type_verify.benchmark_end();
+                }
+            });
+        }
+        group.wait();
+    }
+    if(bm) {
+        print_phase_benchmark(module, verify_batches ? "link_body_type_verify" : "link_body", phase_bm);
+        // the batch that finished last is on the critical path of the phase
+        std::size_t last = 0;
+        std::uint64_t last_end = 0;
+        for(std::size_t i = 0; i < timings.size(); i++) {
+            const auto end = std::max(timings[i].link_body.end_time, timings[i].type_verify.end_time);
+            if(end > last_end) {
+                last_end = end;
+                last = i;
+            }
+        }
+        if(!timings.empty()) {
+            auto& timing = timings[last];
+            auto& batch = batches[last];
+            std::cout << "[SymRes:critical_path] '" << *module << "' ends with " << batch.nodes.size() << " nodes of '" << files[batch.file_index].abs_path << "' link_body [milli:" << timing.link_body.millis() << ']';
+            if(verify_batches) {
+                std::cout << " type_verify [milli:" << timing.type_verify.millis() << ']';
             }
-            return res.has_errors;
-        }));
+            std::cout << " waited [milli:" << ((timing.link_body.start_time - phase_bm.start_time) / 1000000) << ']' << std::endl;
+        }
     }
-    for(auto& f : futures) {
-        auto has_errors = f.get();
-        if(has_errors) {
-            if(options->stop_on_file_error) return 1;
+    // batches are in source order, so diagnostics are printed in the same order as linking files whole
+    // every batch has been linked already, so diagnostics of all of them are printed before stopping
+    for(std::size_t i = 0; i < batches.size(); i++) {
+        auto& res = link_results[i];
+        if(!res.diagnostics.empty()) {
+            Diagnoser::print_diagnostics(res.diagnostics, chem::string_view(files[batches[i].file_index].abs_path), "SymRes:link");
+        }
+        if(res.has_errors) {
             errored = true;
         }
     }
-    futures.clear();
 
     // clear everything allocated during pass 2
     file_allocator.clear();
@@ -625,7 +777,7 @@ int ASTProcessor::sym_res_module(LabModule* module, ctpl::thread_pool& pool) {
     if(errored) return 1;
 
     // link core nodes, only if the module name is core
-    if (module->scope_name.empty() && module->name == "core") {
+    if (is_core_module) {
         // this is the core module
         resolver->link_core_nodes();
     }
@@ -643,10 +795,20 @@ int ASTProcessor::sym_res_module(LabModule* module, ctpl::thread_pool& pool) {
         }
     }
 
+    // the core module is verified (in parallel over batches) after link_core_nodes
+    bool verified = true;
+    if(verify_batches) {
+        verified = report_type_verify_results(module, batches, verify_results);
+    } else if(type_verify) {
+        if(bm) phase_bm.benchmark_begin();
+        verified = type_verify_module_parallel(pool, module);
+        if(bm) print_phase_benchmark(module, "type_verify", phase_bm);
+    }
+
     resolver->module_scope_end(mod_index);
     resolver->stored_file_symbols.clear();
     resolver->current_mod_scope = prev_mod_scope;
-    return 0;
+    return verified ? 0 : 2;
 }
 
 int ASTProcessor::sym_res_module_seq(LabModule* module) {
@@ -707,7 +869,7 @@ ASTFileResult* chem_file_concur_importer_direct(
 #endif
 
 bool ASTProcessor::import_chemical_files_direct(
-        ctpl::thread_pool& pool,
+        WorkStealingPool& pool,
         std::vector<ASTFileMetaData>& files
 ) {
     std::vector<std::future<ASTFileResult*>> futures;
@@ -751,58 +913,24 @@ bool ASTProcessor::import_chemical_files_direct(
     return true;
 }
 
-struct TypeVerifyFileResult {
-    bool has_errors = false;
-    std::vector<Diag> diagnostics;
-};
+bool ASTProcessor::type_verify_module_parallel(WorkStealingPool& pool, LabModule* module) {
+    const auto batches = make_file_batches(module->direct_files);
+    std::vector<TypeVerifyFileResult> results(batches.size());
 
-TypeVerifyFileResult type_verify_file_task(
-    ASTProcessor* processor,
-    ASTFileResult* file
-) {
-    TypeVerifyFileResult result;
-    // make a local diagnoser
-    ASTDiagnoser diagnoser(processor->loc_man);
-
-    // run verification
-    type_verify(processor->resolver->implsIndex, diagnoser, processor->file_allocator, file->unit.scope.body.nodes);
-
-    result.has_errors = diagnoser.has_errors();
-    result.diagnostics = std::move(diagnoser.diagnostics);
-    return result;
-}
-
-bool ASTProcessor::type_verify_module_parallel(ctpl::thread_pool& pool, LabModule* module) {
-    std::vector<std::future<TypeVerifyFileResult>> futures;
-    futures.reserve(module->direct_files.size());
-
-    for(auto& fileData : module->direct_files) {
-        // push task
-        futures.emplace_back(pool.push([this, &fileData](int id){
-            return type_verify_file_task(this, fileData.result);
-        }));
-    }
-
-    bool success = true;
-    int i = 0;
-    for(auto& f : futures) {
-        auto res = f.get();
-        if(res.has_errors) {
-            success = false;
-        }
-        if(!res.diagnostics.empty()) {
-            std::lock_guard<std::mutex> guard(print_mutex);
-            // print diagnostics
-            Diagnoser::print_diagnostics(res.diagnostics, chem::string_view(module->direct_files[i].abs_path), "TypeCheck");
-        }
-        i++;
+    TaskGroup group(pool);
+    for(std::size_t j = 0; j < batches.size(); j++) {
+        // run task
+        group.run([this, nodes = batches[j].nodes, &result = results[j]](int id){
+            result = type_verify_nodes_task(this, nodes);
+        });
     }
+    group.wait();
 
-    return success;
+    return report_type_verify_results(module, batches, results);
 }
 
 void ASTProcessor::import_chemical_files_recursive(
-        ctpl::thread_pool& pool,
+        WorkStealingPool& pool,
         ConcurrentParsingState& state,
         std::vector<ASTFileMetaData>& files,
         bool use_job_allocator
@@ -1025,7 +1153,7 @@ bool import_file_in_lab(
 
 bool ASTProcessor::import_chemical_file_recursive(
         ASTFileResult& result,
-        ctpl::thread_pool& pool,
+        WorkStealingPool& pool,
         ConcurrentParsingState& state,
         ASTFileMetaData& parentFileData,
         bool use_job_allocator
@@ -1078,7 +1206,7 @@ std::pair<ASTFileResult*, std::vector<Token>> chem_file_concur_importer_direct_t
 }
 
 bool ASTProcessor::import_chemical_files_direct_with_tokens(
-        ctpl::thread_pool& pool,
+        WorkStealingPool& pool,
         std::vector<ASTFileMetaData>& files,
         std::unordered_map<unsigned int, std::vector<Token>>& token_map,
         bool keep_comments
@@ -1155,6 +1283,9 @@ bool ASTProcessor::parse_chemical_file(
     result.private_symbol_range = { 0, 0 };
     result.continue_processing = true;
 
+    result.content_hash = hash_contents(inp_source->data(), inp_source->size());
+    result.has_content_hash = true;
+
     auto& unit = result.unit;
 
     Lexer lexer(std::string(abs_path), *inp_source, &binder, file_allocator);
@@ -1245,6 +1376,9 @@ bool ASTProcessor::import_chemical_file(
     result.private_symbol_range = { 0, 0 };
     result.continue_processing = true;
 
+    result.content_hash = hash_contents(inp_source->data(), inp_source->size());
+    result.has_content_hash = true;
+
     auto& unit = result.unit;
 
     Lexer lexer(std::string(abs_path), *inp_source, &binder, file_allocator);
@@ -1339,6 +1473,9 @@ bool ASTProcessor::import_chemical_file_with_tokens(
     result.private_symbol_range = { 0, 0 };
     result.continue_processing = true;
 
+    result.content_hash = hash_contents(inp_source->data(), inp_source->size());
+    result.has_content_hash = true;
+
     auto& unit = result.unit;
 
     Lexer lexer(std::string(abs_path), *inp_source, &binder, file_allocator);
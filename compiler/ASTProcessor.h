@@ -47,9 +47,7 @@ class CTranslator;
 
 #endif
 
-namespace ctpl {
-    class thread_pool;
-}
+class WorkStealingPool;
 
 class AnnotationController;
 
@@ -206,7 +204,7 @@ public:
      * @return true if succeeding importing all files with continue_processing, false otherwise
      */
     bool import_chemical_files_direct(
-            ctpl::thread_pool& pool,
+            WorkStealingPool& pool,
             std::vector<ASTFileMetaData>& files
     );
 
@@ -214,7 +212,7 @@ public:
      * imports given files in parallel and also retains tokens/comments if keep_comments is true
      */
     bool import_chemical_files_direct_with_tokens(
-            ctpl::thread_pool& pool,
+            WorkStealingPool& pool,
             std::vector<ASTFileMetaData>& files,
             std::unordered_map<unsigned int, std::vector<Token>>& token_map,
             bool keep_comments = false
@@ -226,7 +224,7 @@ public:
      * files, it recursively handles import statements
      */
     void import_chemical_files_recursive(
-            ctpl::thread_pool& pool,
+            WorkStealingPool& pool,
             ConcurrentParsingState& state,
             std::vector<ASTFileMetaData>& files,
             bool use_job_allocator
@@ -289,7 +287,7 @@ public:
      * the given 'files' are lexed and parsed into units which are put into 'out_files'
      */
     bool import_module_files_direct(
-            ctpl::thread_pool& pool,
+            WorkStealingPool& pool,
             std::vector<ASTFileMetaData>& files,
             LabModule* module
     );
@@ -339,7 +337,7 @@ public:
      */
     bool import_chemical_file_recursive(
             ASTFileResult& result,
-            ctpl::thread_pool& pool,
+            WorkStealingPool& pool,
             ConcurrentParsingState& state,
             ASTFileMetaData& fileData,
             bool use_job_allocator
@@ -483,9 +481,11 @@ public:
     );
 
     /**
-     * symbol resolves the module, creating the scope
+     * symbol resolves the module, creating the scope, when type_verify is true, the module is
+     * type verified in parallel once every body is linked and core nodes are linked
+     * returns 0 on success, 1 if symbol resolution failed and 2 if type verification failed
      */
-    int sym_res_module(LabModule* module, ctpl::thread_pool& pool);
+    int sym_res_module(LabModule* module, WorkStealingPool& pool, bool type_verify = false);
 
     /**
      * this symbol resolves the module, however sequentially, which means
@@ -503,7 +503,7 @@ public:
     /**
      * verifies the types of the module using parallel threads
      */
-    bool type_verify_module_parallel(ctpl::thread_pool& pool, LabModule* module);
+    bool type_verify_module_parallel(WorkStealingPool& pool, LabModule* module);
 
     /**
      * print given benchmark results with file path
@@ -43,6 +43,7 @@
 #include <llvm/Analysis/TargetLibraryInfo.h>
 #include <llvm/Analysis/TargetTransformInfo.h>
 #include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/IR/DIBuilder.h>
 #include <llvm/IR/DiagnosticInfo.h>
 #include <llvm/IR/IRBuilder.h>
@@ -770,13 +771,26 @@ llvm::Function* Codegen::declare_weak_function(const std::string_view& name, llv
 }
 
 Value*& Codegen::eval_comptime(FunctionCall* call, FunctionDeclaration* decl) {
-    // matching the c translation's evaluate_comptime_func, the comptime
-    // function is always evaluated (never short-circuited on a cached value).
+    // like the c translation's evaluate_comptime_func, a call to a pure function
+    // (checked once per function by the memo) whose arguments are all literals
+    // is keyed by the function's location and the argument values, a literal
+    // result cached for that key in the job is copied here instead of evaluating
+    // the function again, other calls are always evaluated.
     // the evaluated value is kept in evaluated_func_calls so a Value*& can be
     // returned that stays valid across calls. a returned %runtime_value /
     // %runtime_block_value is fully self-contained (its captured comptime
     // variables were evaluated into an evaluated copy at return time), so it
     // can be translated after the interpret scope has been destroyed
+    auto& memo = *comptime_scope.memo;
+    std::string memo_key;
+    const auto memoize = memo.make_key(decl, call, memo_key);
+    if(memoize) {
+        const auto cached = memo.find(memo_key, allocator, comptime_scope.typeBuilder, call->encoded_location());
+        if(cached) {
+            evaluated_func_calls[call] = cached;
+            return evaluated_func_calls[call];
+        }
+    }
     auto prev = comptime_scope.current_func_type;
     comptime_scope.current_func_type = current_func_type;
     const auto prev_runtime_call = comptime_scope.is_runtime_call;
@@ -787,6 +801,10 @@ Value*& Codegen::eval_comptime(FunctionCall* call, FunctionDeclaration* decl) {
 
     // put all diagnostics for this function inside the diagnoser
     auto& diags = comptime_scope.diagnostics;
+    // calls that report diagnostics are evaluated again, to report them at every call site
+    if(memoize && ret && diags.empty()) {
+        memo.put(memo_key, ret);
+    }
     diagnostics.insert(diagnostics.end(), diags.begin(), diags.end());
     comptime_scope.reset_diagnostics();
 
@@ -1381,14 +1399,12 @@ struct TimeTracerRAII {
 };
 
 bool save_as_file_type(
-        Codegen* gen,
+        TargetMachine& target_machine,
+        Module& llvm_module,
         CodegenEmitterOptions* options,
         char** error_message
 ) {
 
-    auto& target_machine = *gen->TargetMachine;
-    auto& llvm_module = *gen->module;
-
     raw_fd_ostream *dest_asm_ptr = nullptr;
     raw_fd_ostream *dest_obj_ptr = nullptr;
     raw_fd_ostream *dest_bitcode_ptr = nullptr;
@@ -1618,7 +1634,47 @@ void configure_emitter_opts(OutputMode mode, CodegenEmitterOptions* options) {
 
 bool Codegen::save_with_options(CodegenEmitterOptions* options) {
     char* error_message = nullptr;
-    bool result = save_as_file_type(this, options, &error_message);
+    bool result = save_as_file_type(*TargetMachine, *module, options, &error_message);
+    if(error_message) {
+        std::cerr << rang::fg::red << "error: " << error_message << ", when emitting files" << rang::fg::reset << std::endl;
+    }
+    return result;
+}
+
+CodegenDetachedModule Codegen::detach_module() {
+    CodegenDetachedModule detached;
+    detached.name = module->getModuleIdentifier();
+    // serializing the module, so it can be read back in a separate context
+    llvm::SmallVector<char, 0> buffer;
+    llvm::raw_svector_ostream stream(buffer);
+    llvm::WriteBitcodeToFile(*module, stream);
+    detached.bitcode.assign(buffer.data(), buffer.size());
+    // target machines shouldn't be shared across threads, so the module gets its own
+    auto& tm = *TargetMachine;
+    detached.target_machine = tm.getTarget().createTargetMachine(
+        tm.getTargetTriple(), tm.getTargetCPU(), tm.getTargetFeatureString(), tm.Options,
+        tm.getRelocationModel(), tm.getCodeModel(), tm.getOptLevel()
+    );
+    return detached;
+}
+
+bool Codegen::emit_detached_module(CodegenDetachedModule& detached, CodegenEmitterOptions* options) {
+    std::unique_ptr<llvm::TargetMachine> target_machine(detached.target_machine);
+    detached.target_machine = nullptr;
+    if(!target_machine) {
+        std::cerr << rang::fg::red << "error: " << "couldn't create target machine for module '" << detached.name << "'" << rang::fg::reset << std::endl;
+        return false;
+    }
+    llvm::LLVMContext context;
+    auto parsed = llvm::parseBitcodeFile(llvm::MemoryBufferRef(llvm::StringRef(detached.bitcode), detached.name), context);
+    if(!parsed) {
+        std::cerr << rang::fg::red << "error: " << llvm::toString(parsed.takeError()) << ", when reading module '" << detached.name << "'" << rang::fg::reset << std::endl;
+        return false;
+    }
+    // the bitcode isn't required anymore, free it before optimizing
+    std::string().swap(detached.bitcode);
+    char* error_message = nullptr;
+    bool result = save_as_file_type(*target_machine, **parsed, options, &error_message);
     if(error_message) {
         std::cerr << rang::fg::red << "error: " << error_message << ", when emitting files" << rang::fg::reset << std::endl;
     }
@@ -5,6 +5,7 @@
 #ifdef COMPILER_BUILD
 
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 #include "ast/utils/Operation.h"
@@ -57,6 +58,20 @@ class CoreNodes;
 
 class ImplementationsIndex;
 
+/**
+ * a module that has been detached from the codegen's llvm context (as bitcode), along
+ * with a target machine of its own, which allows optimizing and emitting it on another thread
+ * while codegen continues with the next module
+ */
+struct CodegenDetachedModule {
+    std::string name;
+    std::string bitcode;
+    /**
+     * owned, released by Codegen::emit_detached_module
+     */
+    llvm::TargetMachine* target_machine = nullptr;
+};
+
 enum class DestructibleKind {
     Single,
     Array
@@ -540,6 +555,18 @@ public:
      */
     bool save_with_options(CodegenEmitterOptions* options);
 
+    /**
+     * detaches the current module, so it can be emitted on another thread
+     * using emit_detached_module
+     */
+    CodegenDetachedModule detach_module();
+
+    /**
+     * optimizes and emits the detached module according to given options, the module is
+     * read into a separate llvm context, so this can be called from any thread
+     */
+    static bool emit_detached_module(CodegenDetachedModule& detached, CodegenEmitterOptions* options);
+
     /**
      * prints the current module as LLVM IR to a .ll file with given out_path
      */
@@ -0,0 +1,197 @@
+// Copyright (c) Chemical Language Foundation 2025.
+
+#include "ComptimeMemo.h"
+#include "preprocess/visitors/RecursiveVisitor.h"
+#include "ast/base/TypeBuilder.h"
+#include "ast/values/IntNumValue.h"
+#include "ast/values/BoolValue.h"
+#include "ast/values/StringValue.h"
+#include "ast/values/FunctionCall.h"
+#include "ast/values/VariableIdentifier.h"
+#include "ast/values/LambdaFunction.h"
+
+/**
+ * visits the body of a function to find out whether it's pure
+ */
+class ComptimePurityChecker : public RecursiveVisitor<ComptimePurityChecker> {
+public:
+
+    ComptimeMemo& memo;
+
+    bool pure = true;
+
+    explicit ComptimePurityChecker(ComptimeMemo& memo) : memo(memo) {
+
+    }
+
+    void VisitFunctionCall(FunctionCall* call) {
+        if(!pure) return;
+        const auto func = call->safe_linked_func();
+        // intrinsics don't have a body, lambdas and function pointers can't be known
+        if(!func || !func->body.has_value() || func->generic_parent || !memo.is_pure(func)) {
+            pure = false;
+            return;
+        }
+        RecursiveVisitor<ComptimePurityChecker>::VisitFunctionCall(call);
+    }
+
+    void VisitVariableIdentifier(VariableIdentifier* value) {
+        const auto linked = value->linked_node();
+        if(linked && linked->kind() == ASTNodeKind::VarInitStmt) {
+            const auto init = linked->as_var_init_unsafe();
+            // a global variable can be changed by other comptime calls
+            if(init->is_top_level() && !init->is_const()) {
+                pure = false;
+            }
+        }
+    }
+
+    void VisitLambdaFunction(LambdaFunction*) {
+        pure = false;
+    }
+
+    void VisitRuntimeValue(RuntimeValue*) {
+        pure = false;
+    }
+
+    void VisitRuntimeBlockValue(RuntimeBlockValue*) {
+        pure = false;
+    }
+
+    void VisitDynamicValue(DynamicValue*) {
+        pure = false;
+    }
+
+    void VisitEmbeddedValue(EmbeddedValue*) {
+        pure = false;
+    }
+
+};
+
+bool ComptimeMemo::is_pure(FunctionDeclaration* decl) {
+    const auto location = decl->encoded_location().encoded;
+    if(location == ZERO_LOC) {
+        return false;
+    }
+    auto found = purity.find(location);
+    if(found != purity.end()) {
+        return found->second;
+    }
+    const auto outermost = decided.empty();
+    // assumed pure while its body is being checked, for recursive calls
+    purity[location] = true;
+    decided.emplace_back(location);
+    ComptimePurityChecker checker(*this);
+    checker.visit_it(decl->body.value());
+    if(checker.pure) {
+        if(outermost) {
+            decided.clear();
+        }
+        return true;
+    }
+    // functions decided pure after this one assumed it pure
+    if(outermost) {
+        for(const auto loc : decided) {
+            purity.erase(loc);
+        }
+        decided.clear();
+    }
+    purity[location] = false;
+    return false;
+}
+
+namespace {
+
+    template<typename T>
+    inline void append_raw(std::string& out, const T& value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+}
+
+bool ComptimeMemo::make_key(FunctionDeclaration* decl, FunctionCall* call, std::string& out) {
+    if(!decl->body.has_value() || decl->generic_parent || decl->get_self_param() || !call->generic_list.empty()) {
+        return false;
+    }
+    // default values and implicit arguments are evaluated in the caller's scope
+    if(call->values.size() != decl->params.size()) {
+        return false;
+    }
+    for(const auto param : decl->params) {
+        if(param->is_implicit()) {
+            return false;
+        }
+    }
+    out.clear();
+    append_raw(out, decl->encoded_location().encoded);
+    for(const auto arg : call->values) {
+        const auto kind = arg->val_kind();
+        out.push_back(static_cast<char>(kind));
+        switch(kind) {
+            case ValueKind::IntN:
+                append_raw(out, arg->as_int_num_value_unsafe()->value);
+                break;
+            case ValueKind::Bool:
+                out.push_back(static_cast<char>(arg->as_bool_unsafe()->value));
+                break;
+            case ValueKind::String: {
+                const auto str = arg->as_string_unsafe();
+                if(str->is_array) return false;
+                append_raw(out, str->value.size());
+                out.append(str->value.data(), str->value.size());
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    std::lock_guard guard(mutex);
+    return is_pure(decl);
+}
+
+Value* ComptimeMemo::find(const std::string& key, ASTAllocator& allocator, TypeBuilder& typeBuilder, SourceLocation location) {
+    std::lock_guard guard(mutex);
+    auto found = results.find(key);
+    if(found == results.end()) {
+        return nullptr;
+    }
+    auto& result = found->second;
+    switch(result.kind) {
+        case ValueKind::IntN:
+            return new (allocator.allocate<IntNumValue>()) IntNumValue(result.bits, typeBuilder.getIntNType(result.int_kind), location);
+        case ValueKind::Bool:
+            return new (allocator.allocate<BoolValue>()) BoolValue(result.bits != 0, typeBuilder.getBoolType(), location);
+        case ValueKind::String: {
+            const auto data = allocator.allocate_str(result.str.data(), result.str.size());
+            return new (allocator.allocate<StringValue>()) StringValue(chem::string_view(data, result.str.size()), typeBuilder.getStringType(), location);
+        }
+        default:
+            return nullptr;
+    }
+}
+
+void ComptimeMemo::put(const std::string& key, Value* result) {
+    Result stored{ result->val_kind(), IntNTypeKind::Int, 0, "" };
+    switch(result->val_kind()) {
+        case ValueKind::IntN: {
+            const auto type = result->as_int_num_value_unsafe()->getType();
+            if(!type) return;
+            stored.int_kind = type->IntNKind();
+            stored.bits = result->as_int_num_value_unsafe()->value;
+            break;
+        }
+        case ValueKind::Bool:
+            stored.bits = result->as_bool_unsafe()->value;
+            break;
+        case ValueKind::String: {
+            const auto str = result->as_string_unsafe();
+            if(str->is_array) return;
+            stored.str.assign(str->value.data(), str->value.size());
+            break;
+        }
+        default:
+            return;
+    }
+    std::lock_guard guard(mutex);
+    results.emplace(key, std::move(stored));
+}
@@ -0,0 +1,96 @@
+// Copyright (c) Chemical Language Foundation 2025.
+
+#pragma once
+
+#include <unordered_map>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include "ast/base/ValueKind.h"
+#include "core/source/SourceLocation.h"
+
+enum class IntNTypeKind;
+
+class FunctionDeclaration;
+
+class FunctionCall;
+
+class Value;
+
+class ASTAllocator;
+
+class TypeBuilder;
+
+/**
+ * caches results of pure comptime function calls, keyed by the function and the constant
+ * arguments, so a call with the same arguments isn't interpreted again at every call site, the
+ * memo is owned by the global interpret scope of the job, so it's shared by all the modules
+ *
+ * only calls whose arguments are literals (integers, bools, strings) are memoized and only
+ * results that are literals are stored, a function is pure when its body only calls functions
+ * that are pure themselves, calls to intrinsics (which talk to the build context or the backend),
+ * lambdas, function pointers, runtime values and mutable globals make a function impure
+ *
+ * functions are identified by their location (not pointer), because nodes of a module are
+ * disposed after it's compiled and their memory is reused for nodes of other modules
+ */
+class ComptimeMemo {
+public:
+
+    /**
+     * computes the key of the call to given function in the out string
+     * returns false if the call can't be memoized
+     */
+    bool make_key(FunctionDeclaration* decl, FunctionCall* call, std::string& out);
+
+    /**
+     * returns a copy of the cached result of the key, allocated with given allocator
+     * at given location, nullptr if no result is cached
+     */
+    Value* find(const std::string& key, ASTAllocator& allocator, TypeBuilder& typeBuilder, SourceLocation location);
+
+    /**
+     * caches the result of the key, results that aren't literals are ignored
+     */
+    void put(const std::string& key, Value* result);
+
+private:
+
+    /**
+     * a literal result, stored by value, so it doesn't depend on the allocator it was evaluated in
+     */
+    struct Result {
+        ValueKind kind;
+        IntNTypeKind int_kind;
+        uint64_t bits;
+        std::string str;
+    };
+
+    /**
+     * checks if the function is pure, the mutex must be held
+     */
+    bool is_pure(FunctionDeclaration* decl);
+
+    friend class ComptimePurityChecker;
+
+    std::mutex mutex;
+
+    /**
+     * location of function → is it pure
+     */
+    std::unordered_map<uint64_t, bool> purity;
+
+    /**
+     * functions decided pure while deciding the purity of the outermost function, a function
+     * that calls itself (directly or not) is assumed pure while its body is being checked, when
+     * the outermost function turns out impure, these decisions are dropped
+     */
+    std::vector<uint64_t> decided;
+
+    /**
+     * the cached results
+     */
+    std::unordered_map<std::string, Result> results;
+
+};
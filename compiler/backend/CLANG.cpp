@@ -2,6 +2,9 @@
 
 #include <clang/Frontend/ASTUnit.h>
 #include <clang/Frontend/CompilerInstance.h>
+#include <clang/Serialization/PCHContainerOperations.h>
+#include <clang/Lex/HeaderSearchOptions.h>
+#include <clang/Basic/FileSystemOptions.h>
 #include <clang/AST/APValue.h>
 #include <clang/AST/Attr.h>
 #include <clang/AST/Expr.h>
@@ -44,6 +47,7 @@
 #include <clang/AST/Mangle.h>
 #include "utils/PathUtils.h"
 #include <filesystem>
+#include <fstream>
 #include "compiler/Codegen.h"
 #include "parser/utils/parse_num.h"
 
@@ -1344,6 +1348,73 @@ void CTranslator::translate(std::vector<std::string>& args, const char* resource
     delete[] args_begin;
 }
 
+static std::string cache_key_path(const std::string& cache_path) {
+    return cache_path + ".key";
+}
+
+clang::ASTUnit* CTranslator::load_cached_unit(const std::string& cache_path, uint64_t cache_key) {
+    std::ifstream key_file(cache_key_path(cache_path), std::ios::binary);
+    if(!key_file.is_open()) {
+        return nullptr;
+    }
+    uint64_t saved_key = 0;
+    key_file.read(reinterpret_cast<char*>(&saved_key), sizeof(saved_key));
+    if(!key_file || saved_key != cache_key || !std::filesystem::exists(cache_path)) {
+        return nullptr;
+    }
+    const auto pch_container_ops = std::make_shared<clang::PCHContainerOperations>();
+    const auto diag_opts = std::make_shared<clang::DiagnosticOptions>();
+    clang::FileSystemOptions fs_opts;
+    clang::HeaderSearchOptions hs_opts;
+    auto unit = clang::ASTUnit::LoadFromASTFile(
+        cache_path,
+        pch_container_ops->getRawReader(),
+        clang::ASTUnit::LoadEverything,
+        llvm::vfs::getRealFileSystem(),
+        diag_opts,
+        diags_engine,
+        fs_opts,
+        hs_opts
+    );
+    if(!unit) {
+        // out of date (an included file changed) or written by a different clang
+        diags_engine->Reset();
+        return nullptr;
+    }
+    return unit.release();
+}
+
+void CTranslator::translate_cached(
+        std::vector<std::string>& args,
+        const char* resources_path,
+        const std::string& cache_path,
+        uint64_t cache_key
+) {
+    std::lock_guard guard(translation_mutex);
+    auto unit = load_cached_unit(cache_path, cache_key);
+    if(!unit) {
+        const char **args_begin;
+        const char **args_end;
+        convertToCharPointers(args, &args_begin, &args_end);
+        unit = get_unit(args_begin, args_end, resources_path);
+        delete[] args_begin;
+        if(!unit) {
+            return;
+        }
+        // key is written only after the unit has been saved successfully
+        if(!unit->Save(cache_path)) {
+            std::ofstream key_file(cache_key_path(cache_path), std::ios::binary);
+            key_file.write(reinterpret_cast<const char*>(&cache_key), sizeof(cache_key));
+        }
+    }
+    // actual translation
+    translate(unit);
+    // dedupe the nodes
+    top_level_dedupe(nodes);
+    // delete the unit (not needed, we already translated)
+    delete unit;
+}
+
 clang::ASTUnit* CTranslator::get_unit_for_header(
         const std::string_view& exe_path,
         const std::string_view& header_path,
@@ -229,6 +229,24 @@ public:
      */
     void translate(std::vector<std::string>& args, const char* resources_path);
 
+    /**
+     * translate unit using given arguments, the parsed clang unit is saved at cache_path, later
+     * invocations with the same cache key load it from there, skipping parsing of the headers
+     * clang validates the included files when loading, so a stale cache is just re-created
+     */
+    void translate_cached(
+        std::vector<std::string>& args,
+        const char* resources_path,
+        const std::string& cache_path,
+        uint64_t cache_key
+    );
+
+    /**
+     * loads the clang unit saved by translate_cached, if cache key matches, otherwise nullptr
+     * CAUTION: just like get_unit, it returns a released pointer and doesn't use a mutex
+     */
+    clang::ASTUnit* load_cached_unit(const std::string& cache_path, uint64_t cache_key);
+
     /**
      * a helper function to get unit for a single header file
      * CAUTION: just like get_unit, it returns a released pointer and doesn't use
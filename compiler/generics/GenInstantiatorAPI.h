@@ -88,7 +88,8 @@ public:
     ASTDiagnoser& getDiagnoser();
 
     /**
-     * get the registration mutex
+     * get the registration mutex, locked around extension function registration
+     * and shallow copies of master implementations
      */
     std::recursive_mutex& getRegistrationMutex();
 
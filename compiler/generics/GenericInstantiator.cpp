@@ -663,9 +663,9 @@ void GenericInstantiator::Clear() {
 }
 
 void GenericInstantiator::activateIteration(BaseGenericDecl* gen_decl, size_t itr) {
-    // lock to prevent concurrent modification of the container's internal
-    // hash map / vectors while we read the instantiation types
-    std::lock_guard<std::recursive_mutex> lock(registration_mutex);
+    // lock to prevent concurrent registration on this declaration
+    // while we read the instantiation types
+    std::lock_guard<std::mutex> lock(gen_decl->registration_mutex);
     auto instantiations = container.getInstantiationTypesFor(gen_decl);
 #ifdef DEBUG
     if(itr >= instantiations.size()) {
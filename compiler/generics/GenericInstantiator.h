@@ -67,9 +67,9 @@ public:
     ImplementationsIndex& implsIndex;
 
     /**
-     * the registration mutex (recursive) is used to register instantiations
-     * and finalize signatures atomically, so they can be used among threads safely.
-     * recursive because signature finalization may recursively register new generic types.
+     * the registration mutex (recursive) serializes registering extension functions on
+     * containers with shallow copying master implementations (which copies them), checking
+     * and registering instantiations is locked per generic declaration instead
      */
     std::recursive_mutex& registration_mutex;
 
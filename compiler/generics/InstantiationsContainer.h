@@ -6,6 +6,7 @@
 #include <unordered_map>
 #include <vector>
 #include <mutex>
+#include <shared_mutex>
 #include <condition_variable>
 
 #include <cassert>
@@ -24,10 +25,28 @@ struct RegistryPosition {
     unsigned int index;
 };
 
+/**
+ * structural hash of an instantiation's types, instantiations whose types can't
+ * be hashed (for example containing generic parameters which match loosely) are
+ * always compared
+ */
+struct InstantiationHash {
+    std::size_t value;
+    bool hashed;
+};
+
 struct DeclInstantiations {
     // the types that caused the instantiation are stored in this
     // types vector
     std::vector<InstantiationType>       types;
+    // same length as 'types', the structural hash of each instantiation
+    std::vector<InstantiationHash>       hashes;
+    // hash → indexes of instantiations (in registration order) with that hash
+    std::unordered_map<std::size_t, std::vector<unsigned int>> hashIndex;
+    // indexes of instantiations that couldn't be hashed (in registration order)
+    std::vector<unsigned int>            unhashed;
+    // when instantiations are removed, indexes move, the hash index is rebuilt lazily
+    bool                                 indexDirty = false;
     // this is a reference to the instantiations vector stored in generic declaration
     // present in the ast, since every generic declaration owns the vector for instantiations
     // which can contain different pointers we use reference to vec to void*
@@ -52,6 +71,31 @@ struct RegistryEntry {
 class InstantiationsContainer {
 private:
 
+    /**
+     * puts the instantiation at given index into the hash index
+     */
+    static void indexInstantiation(DeclInstantiations& decl, unsigned int index) {
+        auto& hash = decl.hashes[index];
+        if (hash.hashed) {
+            decl.hashIndex[hash.value].push_back(index);
+        } else {
+            decl.unhashed.push_back(index);
+        }
+    }
+
+    /**
+     * rebuilds the hash index, after instantiations have been moved
+     */
+    static void rebuildHashIndex(DeclInstantiations& decl) {
+        decl.hashIndex.clear();
+        decl.unhashed.clear();
+        const auto total = static_cast<unsigned int>(decl.hashes.size());
+        for (unsigned int i = 0; i < total; ++i) {
+            indexInstantiation(decl, i);
+        }
+        decl.indexDirty = false;
+    }
+
     // key → its list of instantiations
     std::unordered_map<void*, DeclInstantiations> instantiations;
     // fileId → vector of "who to delete" records
@@ -60,6 +104,10 @@ private:
     // we track current module instantiations
     std::vector<ASTNode*> current_module_instantiations;
 
+    // guards the maps above and the current module instantiations, the data of a
+    // single key is guarded by the registration mutex of its generic declaration
+    std::shared_mutex map_mutex;
+
     // mutex protecting instantiation status changes across all generic decls
     std::mutex inst_status_mutex;
 
@@ -83,12 +131,31 @@ public:
      * Gets all the instantiations for the given key
      */
     std::span<InstantiationType> getInstantiationTypesFor(void* key) {
+        std::shared_lock<std::shared_mutex> lock(map_mutex);
         auto it = instantiations.find(key);
         if (it == instantiations.end())
             return {};
         return it->second.types;
     }
 
+    /**
+     * Gets the instantiations data for the given key, null if none registered
+     * the hash index is brought up to date before returning
+     */
+    DeclInstantiations* getDeclInstantiations(void* key) {
+        std::shared_lock<std::shared_mutex> lock(map_mutex);
+        auto it = instantiations.find(key);
+        if (it == instantiations.end())
+            return nullptr;
+        lock.unlock();
+        // map nodes are stable, rehashing doesn't move the data of this key
+        auto& decl = it->second;
+        if (decl.indexDirty) {
+            rebuildHashIndex(decl);
+        }
+        return &decl;
+    }
+
     /**
      * Register a new instantiation under `key` coming from `fileId`.
      * - `types` is your span of BaseType*
@@ -97,13 +164,16 @@ public:
     size_t registerInstantiation(
             void*                        key,
             InstantiationType            types,
+            InstantiationHash            hash,
             std::vector<void*>&          instVec,
             unsigned int current_file_id
     ) {
+        std::lock_guard<std::shared_mutex> lock(map_mutex);
+
         // 1) Grab-or-create our DeclInstantiations
         auto [it, inserted] = instantiations.try_emplace(
                 key,
-                DeclInstantiations{ {}, instVec, {} }
+                DeclInstantiations{ {}, {}, {}, {}, false, instVec, {} }
         );
         auto& decl = it->second;
 
@@ -114,7 +184,11 @@ public:
         // 3) Append new instantiation
         auto instIdx = static_cast<unsigned int>(decl.types.size());
         decl.types          .push_back(types);
+        decl.hashes         .push_back(hash);
         decl.registryPositions.push_back({ current_file_id, regPos });
+        if (!decl.indexDirty) {
+            indexInstantiation(decl, instIdx);
+        }
 
         // 4) Remember to delete it later
         registry.push_back({ key, instIdx });
@@ -178,6 +252,7 @@ public:
             if (removeIdx != lastIdx) {
                 // 1) swap our vectors’ entries
                 std::swap(decl.types[removeIdx],       decl.types[lastIdx]);
+                std::swap(decl.hashes[removeIdx],      decl.hashes[lastIdx]);
                 std::swap(decl.implData[removeIdx],    decl.implData[lastIdx]);
                 std::swap(decl.registryPositions[removeIdx], decl.registryPositions[lastIdx]);
 
@@ -195,6 +270,8 @@ public:
 
             // pop our key’s data
             decl.types.pop_back();
+            decl.hashes.pop_back();
+            decl.indexDirty = true;
             decl.implData.pop_back();
             decl.registryPositions.pop_back();
 
@@ -210,6 +287,7 @@ public:
      * track a instantiation created in the current module
      */
     void put_current_module_instantiation(ASTNode* node) {
+        std::lock_guard<std::shared_mutex> lock(map_mutex);
         current_module_instantiations.emplace_back(node);
     }
 
@@ -38,7 +38,6 @@
 #include "preprocess/2c/2cASTVisitor.h"
 #include "compiler/lab/LabBuildContext.h"
 #include "integration/libtcc/LibTccInteg.h"
-#include "ctpl.h"
 #include "compiler/InvokeUtils.h"
 #include "utils/PathUtils.h"
 #include "preprocess/RepresentationVisitor.h"
@@ -49,6 +48,7 @@
 #include <utility>
 #include <functional>
 #include "utils/FileUtils.h"
+#include "utils/ContentHash.h"
 #include "compiler/backend/LLVMBackendContext.h"
 #include "preprocess/2c/2cBackendContext.h"
 #include "compiler/cbi/model/CompilerBinder.h"
@@ -447,6 +447,33 @@ std::string get_translated_c_path(const std::string_view& build_dir, LabModule*
     return resolve_rel_child_path_str(build_dir, f);
 }
 
+std::string get_c_headers_cache_path(const std::string_view& build_dir, LabModule* mod) {
+    auto f = mod->format('.');
+    f.append("/headers.ast");
+    return resolve_rel_child_path_str(build_dir, f);
+}
+
+/**
+ * the key for the cached translation of module's c headers, made from the clang args (which
+ * contain the header paths), contents of the headers, resources path and the target triple
+ */
+uint64_t c_headers_cache_key(LabModule* mod, const std::vector<std::string>& args, const std::string& resources_path, const chem::string& target_triple) {
+    uint64_t key = 0;
+    for(auto& arg : args) {
+        key = combine_content_hash(key, hash_contents(arg.data(), arg.size()));
+    }
+    for(auto& header : mod->headers) {
+        // headers given by name (searched in include paths) can't be hashed here, clang
+        // checks every included file for changes when loading the cache anyway
+        uint64_t header_hash = 0;
+        hash_file_contents(header.to_view(), header_hash);
+        key = combine_content_hash(key, header_hash);
+    }
+    key = combine_content_hash(key, hash_contents(resources_path.data(), resources_path.size()));
+    key = combine_content_hash(key, hash_contents(target_triple.data(), target_triple.size()));
+    return key;
+}
+
 bool has_module_changed_recursive(LabBuildCompiler* compiler, LabModule* module, const std::string& build_dir, bool use_tcc, bool is_single_file) {
     const auto verbose = compiler->options->verbose;
     if(use_tcc && module->type == LabModuleType::CPPFile) {
@@ -815,19 +842,16 @@ int LabBuildCompiler::process_module_tcc(
         std::cout << "[lab] " << "resolving symbols in the module " << *mod << std::endl;
     }
 
-    // symbol resolve all the files in the module
-    const auto sym_res_status = processor.sym_res_module(mod, pool);
-    if(sym_res_status != 0) {
-        std::cout << "[lab] " << rang::fg::red << "error: " << rang::fg::reset << "failure during symbol resolution in the module " << *mod << std::endl;
-        return sym_res_status;
-    }
-
-    // type verify the module
-    if(!processor.type_verify_module_parallel(pool, mod)) {
+    // symbol resolve all the files in the module, then type verify them once all bodies are linked
+    const auto sym_res_status = processor.sym_res_module(mod, pool, true);
+    if(sym_res_status == 2) {
         if(verbose) {
             std::cout << "[lab] " << "failure during type verification in the module " << *mod << std::endl;
         }
         return 1;
+    } else if(sym_res_status != 0) {
+        std::cout << "[lab] " << rang::fg::red << "error: " << rang::fg::reset << "failure during symbol resolution in the module " << *mod << std::endl;
+        return sym_res_status;
     }
 
     // don't compile when user asked for checking only
@@ -914,6 +938,9 @@ int LabBuildCompiler::process_module_tcc(
                     // declare it ourselves
                     processor.declare_module(c_visitor, mod);
 
+                    // the module isn't implemented (which resets these per file), its nodes are disposed below
+                    c_visitor.names_reset();
+
                 }
 
             }
@@ -1109,7 +1136,16 @@ int LabBuildCompiler::process_module_gen(
         auto prev_check = cTranslator.check_decls_across_invocations;
         cTranslator.check_decls_across_invocations = false;
         // translate
-        cTranslator.translate(args, options->resources_path.c_str());
+        if(caching) {
+            // parsed headers are cached in the module's build directory, so clang doesn't parse them on every build
+            auto cache_path = get_c_headers_cache_path(build_dir, mod);
+            std::error_code ec;
+            fs::create_directories(fs::path(cache_path).parent_path(), ec);
+            const auto cache_key = c_headers_cache_key(mod, args, options->resources_path, job->target_triple);
+            cTranslator.translate_cached(args, options->resources_path.c_str(), cache_path, cache_key);
+        } else {
+            cTranslator.translate(args, options->resources_path.c_str());
+        }
         cTranslator.check_decls_across_invocations = prev_check;
         auto& nodes = cTranslator.nodes;
         // symbol resolving c nodes, really fast -- just declaring their id's as less than public specifier
@@ -1124,17 +1160,12 @@ int LabBuildCompiler::process_module_gen(
         std::cout << "[lab] " << "resolving symbols in the module" << std::endl;
     }
 
-    // symbol resolve all the files in the module
-    const auto sym_res_status = processor.sym_res_module(mod, pool);
+    // symbol resolve all the files in the module, then type verify them once all bodies are linked
+    const auto sym_res_status = processor.sym_res_module(mod, pool, true);
     if(sym_res_status != 0) {
         return 1;
     }
 
-    // type verify the module
-    if(!processor.type_verify_module_parallel(pool, mod)) {
-        return 1;
-    }
-
     // check if module has not changed, and use cache appropriately
     // not changed means object file is also present (currently
     if(mod->has_changed.has_value() && !mod->has_changed.value() && !job->attrs.check_only) {
@@ -1235,26 +1266,60 @@ int LabBuildCompiler::process_module_gen(
         emitter_options.obj_path = mod->object_path.data();
     }
 
+    // intermediate jobs don't emit anything (unless ir or assembly is requested), so the module
+    // isn't optimized, and it doesn't need to be detached
+    if(!emitter_options.ir_path && !emitter_options.asm_path && !emitter_options.bitcode_path && !emitter_options.obj_path) {
+        return 0;
+    }
+
     auto& gen_path = is_use_obj_format ? mod->object_path : mod->bitcode_path;
     if(verbose) {
         std::cout << "[lab] emitting the module '" << mod->name << "' at '" << gen_path << '\'' << std::endl;
     }
 
-    // creating a object or bitcode file
-    const bool save_result = gen.save_with_options(&emitter_options);
-    if(save_result) {
-        if(caching && !gen_path.empty()) {
-            save_mod_timestamp(direct_files, get_mod_timestamp_path(build_dir, mod, false), options->out_mode);
+    // the module is detached from the llvm context, so it's optimized and emitted
+    // on the pool, while we generate code for the next module
+    auto timestamp_path = caching && !gen_path.empty() ? get_mod_timestamp_path(build_dir, mod, false) : std::string();
+    auto bm = options->benchmark_modules ? std::make_unique<BenchmarkResults>() : nullptr;
+    auto result = pool.push([mod, emitter_options, is_use_obj_format, detached = gen.detach_module(), timestamp_path = std::move(timestamp_path), out_mode = options->out_mode, bm = bm.get()](int) mutable -> bool {
+        if(bm) {
+            bm->benchmark_begin();
         }
-    } else {
-        std::cerr << "[lab] failed to emit file '" << gen_path << '\'' << std::endl;
-        return 1;
-    }
+        auto& gen_path = is_use_obj_format ? mod->object_path : mod->bitcode_path;
+        const auto emitted = Codegen::emit_detached_module(detached, &emitter_options);
+        if(bm) {
+            bm->benchmark_end();
+        }
+        if(emitted) {
+            if(!timestamp_path.empty()) {
+                save_mod_timestamp(mod->direct_files, timestamp_path, out_mode);
+            }
+            return true;
+        } else {
+            std::cerr << "[lab] failed to emit file '" << gen_path << '\'' << std::endl;
+            return false;
+        }
+    });
+    module_emissions.emplace_back(LabModuleEmission { mod, std::move(result), std::move(bm) });
 
     return 0;
 
 }
 
+bool LabBuildCompiler::wait_module_emissions() {
+    bool success = true;
+    for(auto& emission : module_emissions) {
+        if(!emission.result.get()) {
+            success = false;
+        } else if(emission.bm) {
+            // module benchmarks only include code generation, emission happens on the pool
+            ASTProcessor::print_benchmarks(std::cout, "bm:emit", emission.module->format(), emission.bm.get());
+        }
+    }
+    module_emissions.clear();
+    return success;
+}
+
 #endif
 
 void begin_job_print(LabJob* job) {
@@ -2083,6 +2148,7 @@ int LabBuildCompiler::process_job_gen(LabJob* job) {
                         }
                         continue;
                     } else {
+                        wait_module_emissions();
                         return 1;
                     }
                 } else {
@@ -2105,6 +2171,7 @@ int LabBuildCompiler::process_job_gen(LabJob* job) {
 
         const auto result = process_module_gen_bm(mod, processor, gen, cTranslator, job, mods_dir);
         if(result != 0) {
+            wait_module_emissions();
             return result;
         }
 
@@ -2116,6 +2183,11 @@ int LabBuildCompiler::process_job_gen(LabJob* job) {
 
     }
 
+    // objects must be present before they are linked
+    if(!wait_module_emissions()) {
+        return 1;
+    }
+
     return 0;
 
 }
@@ -4868,19 +4940,16 @@ int LabBuildCompiler::do_interpretation_job(LabJob* job) {
             return 1;
         }
 
-        // symbol resolve
-        const auto sym_res_status = processor.sym_res_module(mod, pool);
-        if(sym_res_status != 0) {
-            std::cout << "[lab] " << rang::fg::red << "error: " << rang::fg::reset << "failure during symbol resolution in the module " << *mod << std::endl;
-            return sym_res_status;
-        }
-
-        // type verify
-        if(!processor.type_verify_module_parallel(pool, mod)) {
+        // symbol resolve and type verify
+        const auto sym_res_status = processor.sym_res_module(mod, pool, true);
+        if(sym_res_status == 2) {
             if(verbose) {
                 std::cout << "[lab] " << "failure during type verification in the module " << *mod << std::endl;
             }
             return 1;
+        } else if(sym_res_status != 0) {
+            std::cout << "[lab] " << rang::fg::red << "error: " << rang::fg::reset << "failure during symbol resolution in the module " << *mod << std::endl;
+            return sym_res_status;
         }
     }
 
@@ -8,7 +8,7 @@
 #include <unordered_set>
 #include "LabBuildCompilerOptions.h"
 #include "LabJob.h"
-#include "ctpl.h"
+#include "utils/WorkStealingPool.h"
 #include "compiler/cbi/model/CompilerBinder.h"
 #include "core/source/LocationManager.h"
 #include "preprocess/ImportPathHandler.h"
@@ -19,6 +19,8 @@
 #include "compiler/processor/ModuleDependencyRecord.h"
 #include "ast/base/TypeBuilder.h"
 #include "compiler/frontend/AnnotationController.h"
+#include "utils/Benchmark.h"
+#include <memory>
 
 class ASTAllocator;
 
@@ -36,6 +38,28 @@ class TypeBuilder;
 
 #ifdef COMPILER_BUILD
 class Codegen;
+
+/**
+ * a module being optimized and emitted on the pool
+ */
+struct LabModuleEmission {
+
+    /**
+     * the module being emitted
+     */
+    LabModule* module;
+
+    /**
+     * false if the emission failed
+     */
+    std::future<bool> result;
+
+    /**
+     * time taken by the emission, present when modules are benchmarked
+     */
+    std::unique_ptr<BenchmarkResults> bm;
+
+};
 #endif
 
 /**
@@ -104,7 +128,7 @@ public:
      * creating a thread pool for all our jobs in the lab build
      * Initialize thread pool with the number of available hardware threads
      */
-    ctpl::thread_pool pool;
+    WorkStealingPool pool;
 
     /**
      * the global container contains namespaces like std and compiler
@@ -157,6 +181,16 @@ public:
      */
     ASTAllocator* file_allocator = nullptr;
 
+#ifdef COMPILER_BUILD
+
+    /**
+     * modules are optimized and emitted on the pool, while code generation
+     * continues with the next module, these must be waited before linking
+     */
+    std::vector<LabModuleEmission> module_emissions;
+
+#endif
+
     /**
      * constructor
      */
@@ -243,6 +277,12 @@ public:
             const std::string_view& build_dir
     );
 
+    /**
+     * waits for all the pending module emissions, returns false
+     * if emission of any module failed, emission benchmarks are printed in module order
+     */
+    bool wait_module_emissions();
+
 #endif
 
     /**
@@ -1,6 +1,7 @@
 // Copyright (c) Chemical Language Foundation 2025.
 
 #include "Timestamp.h"
+#include "utils/ContentHash.h"
 #include <filesystem>
 #include <fstream>
 #include <algorithm>
@@ -8,58 +9,124 @@
 namespace fs = std::filesystem;
 
 /**
- * save mod timestamp data (modified date and file size) in a file that can be read later and compared
- * to check if files have changed
+ * written at the start of timestamp file, timestamp files written in an older format
+ * are considered invalid, so modules are rebuilt once when the format changes
  */
-void save_mod_timestamp(const std::vector<std::string_view>& files, const std::string_view& output_file, OutputMode mode) {
-    // sort files to ensure deterministic order regardless of source ordering
-    std::vector<std::string_view> sorted_files(files.begin(), files.end());
-    std::sort(sorted_files.begin(), sorted_files.end());
+static constexpr uint32_t timestamp_format = 0x33535443; // "CTS3"
+
+/**
+ * a file whose timestamp is saved, the content hash is known when the file was
+ * read by the lexer, otherwise the file is hashed when saving
+ */
+struct TimestampFile {
+    std::string_view abs_path;
+    const uint64_t* content_hash;
+};
+
+/**
+ * a file entry with the values that are written to the timestamp file
+ */
+struct TimestampEntry {
+    std::string_view abs_path;
+    uintmax_t file_size;
+    fs::file_time_type mod_time;
+    uint64_t content_hash;
+};
+
+static void write_mod_timestamp(const std::vector<TimestampEntry>& entries, const std::string_view& output_file, OutputMode mode) {
 
     std::ofstream ofs(output_file.data(), std::ios::binary);
-    size_t num_files = sorted_files.size();
+    ofs.write(reinterpret_cast<const char*>(&timestamp_format), sizeof(timestamp_format));
+
+    size_t num_files = entries.size();
     ofs.write(reinterpret_cast<const char*>(&num_files), sizeof(num_files));
 
     // write the mode
     int mode_int = static_cast<int>(mode);
     ofs.write(reinterpret_cast<const char*>(&mode_int), sizeof(mode_int));
 
-    for (const auto& file_abs_path : sorted_files) {
-        fs::path file_path(file_abs_path);
+    for (const auto& entry : entries) {
+        size_t file_str_size = entry.abs_path.size();
+        ofs.write(reinterpret_cast<const char*>(&file_str_size), sizeof(file_str_size));
+        ofs.write(entry.abs_path.data(), (std::streamsize) file_str_size);
+        ofs.write(reinterpret_cast<const char*>(&entry.file_size), sizeof(entry.file_size));
+        ofs.write(reinterpret_cast<const char*>(&entry.mod_time), sizeof(entry.mod_time));
+        ofs.write(reinterpret_cast<const char*>(&entry.content_hash), sizeof(entry.content_hash));
+    }
+}
+
+static void save_mod_timestamp(std::vector<TimestampFile>& files, const std::string_view& output_file, OutputMode mode) {
+    // sort files to ensure deterministic order regardless of source ordering
+    std::sort(files.begin(), files.end(), [](const TimestampFile& a, const TimestampFile& b) {
+        return a.abs_path < b.abs_path;
+    });
+
+    std::vector<TimestampEntry> entries;
+    entries.reserve(files.size());
+
+    for (const auto& file : files) {
+        fs::path file_path(file.abs_path);
         if (fs::exists(file_path)) {
-            uintmax_t file_size = fs::file_size(file_path);
-            auto mod_time = fs::last_write_time(file_path);
-            size_t file_str_size = file_abs_path.size();
-            ofs.write(reinterpret_cast<const char*>(&file_str_size), sizeof(file_str_size));
-            ofs.write(file_abs_path.data(), (std::streamsize) file_str_size);
-            ofs.write(reinterpret_cast<const char*>(&file_size), sizeof(file_size));
-            ofs.write(reinterpret_cast<const char*>(&mod_time), sizeof(mod_time));
+            // files that can't be read are saved with a zero hash, which never matches the hash of a file
+            uint64_t content_hash = 0;
+            if(file.content_hash) {
+                content_hash = *file.content_hash;
+            } else {
+                hash_file_contents(file.abs_path, content_hash);
+            }
+            entries.push_back(TimestampEntry { file.abs_path, fs::file_size(file_path), fs::last_write_time(file_path), content_hash });
         }
     }
+
+    write_mod_timestamp(entries, output_file, mode);
+}
+
+/**
+ * the content hash computed from the buffer the lexer read, if the file has been parsed
+ */
+static inline const uint64_t* parsed_content_hash(const ASTFileResult* result) {
+    return result != nullptr && result->has_content_hash ? &result->content_hash : nullptr;
+}
+
+/**
+ * save mod timestamp data (modified date, file size and content hash) in a file that can be read later and compared
+ * to check if files have changed
+ */
+void save_mod_timestamp(const std::vector<std::string_view>& files, const std::string_view& output_file, OutputMode mode) {
+    std::vector<TimestampFile> timestamp_files;
+    timestamp_files.reserve(files.size());
+    for(const auto& f : files) {
+        timestamp_files.push_back(TimestampFile { f, nullptr });
+    }
+    save_mod_timestamp(timestamp_files, output_file, mode);
 }
 
 void save_mod_timestamp(const std::vector<ASTFileMetaData>& files, const std::string_view& output_file, OutputMode mode) {
-    std::vector<std::string_view> paths;
-    paths.reserve(files.size());
+    std::vector<TimestampFile> timestamp_files;
+    timestamp_files.reserve(files.size());
     for(const auto& f : files) {
-        paths.emplace_back(f.abs_path);
+        timestamp_files.push_back(TimestampFile { f.abs_path, parsed_content_hash(f.result) });
     }
-    save_mod_timestamp(paths, output_file, mode);
+    save_mod_timestamp(timestamp_files, output_file, mode);
 }
 
 void save_mod_timestamp(const std::vector<ASTFileResult*>& files, const std::string_view& output_file, OutputMode mode) {
-    std::vector<std::string_view> paths;
-    paths.reserve(files.size());
+    std::vector<TimestampFile> timestamp_files;
+    timestamp_files.reserve(files.size());
     for(const auto f : files) {
-        paths.emplace_back(f->abs_path);
+        timestamp_files.push_back(TimestampFile { f->abs_path, parsed_content_hash(f) });
     }
-    save_mod_timestamp(paths, output_file, mode);
+    save_mod_timestamp(timestamp_files, output_file, mode);
 }
 
 bool compare_mod_timestamp(const std::vector<std::string_view>& files, const std::string_view& prev_timestamp_file, OutputMode mode) {
     std::ifstream ifs(prev_timestamp_file.data(), std::ios::binary);
     if (!ifs.is_open()) return false;
 
+    uint32_t prev_format = 0;
+    ifs.read(reinterpret_cast<char*>(&prev_format), sizeof(prev_format));
+    if (!ifs || prev_format != timestamp_format) return false;
+
     size_t prev_num_files;
     ifs.read(reinterpret_cast<char*>(&prev_num_files), sizeof(prev_num_files));
     if (prev_num_files != files.size()) return false;
@@ -72,6 +139,11 @@ bool compare_mod_timestamp(const std::vector<std::string_view>& files, const std
     std::vector<std::string_view> sorted(files.begin(), files.end());
     std::sort(sorted.begin(), sorted.end());
 
+    // current values of the files, written back if only modification times changed
+    std::vector<TimestampEntry> current;
+    current.reserve(prev_num_files);
+    bool mod_time_changed = false;
+
     for (size_t i = 0; i < prev_num_files; i++) {
         size_t file_str_size;
         ifs.read(reinterpret_cast<char*>(&file_str_size), sizeof(file_str_size));
@@ -90,16 +162,38 @@ bool compare_mod_timestamp(const std::vector<std::string_view>& files, const std
         fs::file_time_type saved_mod_time;
         ifs.read(reinterpret_cast<char*>(&saved_mod_time), sizeof(saved_mod_time));
 
+        uint64_t saved_hash;
+        ifs.read(reinterpret_cast<char*>(&saved_hash), sizeof(saved_hash));
+        if (!ifs) return false;
+
         // stat the current file
         fs::path file_path(sorted[i]);
         if (!fs::exists(file_path)) return false;
 
         uintmax_t current_file_size = fs::file_size(file_path);
-        auto current_mod_time = fs::last_write_time(file_path);
-
-        if (saved_size != current_file_size || saved_mod_time != current_mod_time) {
+        if (saved_size != current_file_size) {
             return false;
         }
+
+        uint64_t current_hash = saved_hash;
+        auto current_mod_time = fs::last_write_time(file_path);
+        if (saved_mod_time != current_mod_time) {
+            // a checkout or git switch touches files without changing them, only the contents
+            // are compared, which are hashed only when modification time differs
+            if (!hash_file_contents(sorted[i], current_hash) || current_hash != saved_hash) {
+                return false;
+            }
+            mod_time_changed = true;
+        }
+
+        current.push_back(TimestampEntry { sorted[i], current_file_size, current_mod_time, current_hash });
+    }
+
+    ifs.close();
+
+    // contents are the same, saving the new modification times, so files aren't hashed again next time
+    if(mod_time_changed) {
+        write_mod_timestamp(current, prev_timestamp_file, mode);
     }
 
     return true;
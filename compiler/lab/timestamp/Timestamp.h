@@ -9,7 +9,7 @@
 #include "compiler/OutputMode.h"
 
 /**
- * save mod timestamp data (modified date and file size) in a file that can be read later and compared
+ * save mod timestamp data (modified date, file size and content hash) in a file that can be read later and compared
  * to check if files have changed
  */
 void save_mod_timestamp(const std::vector<std::string_view>& files, const std::string_view& output_file, OutputMode mode);
@@ -18,6 +18,10 @@ void save_mod_timestamp(const std::vector<ASTFileMetaData>& files, const std::st
 
 void save_mod_timestamp(const std::vector<ASTFileResult*>& files, const std::string_view& output_file, OutputMode mode);
 
+/**
+ * compares the files with the saved timestamp file, returns true if none of the files have changed
+ * when the modification time of a file differs, its contents are hashed and compared with saved hash
+ */
 bool compare_mod_timestamp(const std::vector<std::string_view>& files, const std::string_view& prev_timestamp_file, OutputMode mode);
 
 bool compare_mod_timestamp(const std::vector<ASTFileMetaData>& files, const std::string_view& prev_timestamp_file, OutputMode mode);
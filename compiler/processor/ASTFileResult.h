@@ -37,6 +37,17 @@ struct ASTFileResult : ASTFileMetaData {
      */
     SymResSignatureResult sig_result;
 
+    /**
+     * hash of the file contents, computed from the buffer the lexer read, so module
+     * timestamps can be saved without reading the file again
+     */
+    uint64_t content_hash = 0;
+
+    /**
+     * is the content hash computed, false when the file hasn't been read
+     */
+    bool has_content_hash = false;
+
     /**
      * if read error occurred this would contain it
      */
@@ -40,9 +40,7 @@ void declareChildren(SymbolResolver& linker, ChildrenMapNode* node, ImportStatem
         auto& alias = stmt->getTopLevelAlias();
         if(alias.empty()) {
             // user asked to declare all the symbols
-            for(auto& sym : node->symbols) {
-                linker.declare_or_shadow(sym.first, sym.second);
-            }
+            linker.declare_layer(node->get_layer());
         } else {
             linker.declare(alias, node);
         }
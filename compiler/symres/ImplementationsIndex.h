@@ -2,9 +2,11 @@
 
 #pragma once
 
-#include <unordered_map>
+#include <atomic>
+#include <memory>
+#include <vector>
 #include <mutex>
-#include <shared_mutex>
+#include <cstdint>
 #include "ast/utils/Operation.h"
 
 class ASTNode;
@@ -24,12 +26,24 @@ struct ImplementationIndexKey {
 };
 
 struct ImplementationIndexKeyHash {
-    std::size_t operator()(const ImplementationIndexKey& k) const {
-        const auto h1 = std::hash<const void*>{}((void*) k.interface);
-        const auto h2 = std::hash<const void*>{}((void*) k.for_);
-        // Combine hashes
-        return h1 ^ (h2 << 1);
+
+    /**
+     * mixes the bits of the pointer, pointers are aligned and allocated close to each
+     * other, so their low bits can't be used directly
+     */
+    static inline std::size_t mix(std::uint64_t x) noexcept {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return static_cast<std::size_t>(x);
     }
+
+    std::size_t operator()(const ImplementationIndexKey& k) const noexcept {
+        return mix(reinterpret_cast<std::uintptr_t>(k.interface) ^ mix(reinterpret_cast<std::uintptr_t>(k.for_)));
+    }
+
 };
 
 /**
@@ -45,16 +59,135 @@ struct ImplementationIndexKeyHash {
  * why use one map for all instantiations, because we can store a type pointer (BaseType*) too, and a Struct pointer (ASTNode*) too
  */
 class ImplementationsIndex {
-public:
+private:
+
+    /**
+     * a slot of the table, the implementation is stored last, so a reader
+     * that sees the implementation sees the key too
+     */
+    struct Slot {
+        std::atomic<ASTNode*> interface{ nullptr };
+        std::atomic<ASTAny*> for_{ nullptr };
+        std::atomic<ImplDefinition*> impl{ nullptr };
+    };
+
+    /**
+     * an open addressing table (linear probing), capacity is a power of two
+     */
+    struct Table {
+        std::size_t mask;
+        std::unique_ptr<Slot[]> slots;
+        explicit Table(std::size_t capacity) : mask(capacity - 1), slots(new Slot[capacity]) {
+
+        }
+    };
+
+    /**
+     * the table readers look into, lookups don't take any lock
+     */
+    std::atomic<Table*> current{ nullptr };
+
+    /**
+     * all the tables, a table that has been replaced when growing may still be
+     * in use by a reader, so tables are freed only when the index is cleared
+     */
+    std::vector<std::unique_ptr<Table>> tables;
+
+    /**
+     * number of implementations in the current table
+     */
+    std::size_t count = 0;
+
+    /**
+     * a lookup that missed, remembered by the thread that looked it up
+     */
+    struct NegativeEntry {
+        ASTNode* interface;
+        ASTAny* for_;
+        std::uint64_t generation;
+    };
+
+    /**
+     * number of misses remembered per thread (shared by all the indexes)
+     */
+    static constexpr std::size_t NEGATIVE_CACHE_SIZE = 256;
+
+    /**
+     * generations are unique across all the indexes, so a remembered miss is
+     * only valid for the index (and the contents) it was looked up in
+     */
+    static inline std::atomic<std::uint64_t> next_generation{ 1 };
+
+    /**
+     * changed after every add and clear, misses remembered before are invalid after it
+     */
+    std::atomic<std::uint64_t> generation{ next_generation.fetch_add(1, std::memory_order_relaxed) };
+
+    /**
+     * the misses remembered by the current thread
+     */
+    static inline NegativeEntry* negative_cache() {
+        static thread_local NegativeEntry cache[NEGATIVE_CACHE_SIZE] = {};
+        return cache;
+    }
+
+    /**
+     * writers are serialized, implementations are added much less often than looked up
+     */
+    std::mutex write_mutex;
 
-    std::unordered_map<ImplementationIndexKey, ImplDefinition*, ImplementationIndexKeyHash> map_;
+    /**
+     * puts the entry in the table (without checking for existing key), write mutex must be held
+     */
+    static void put(Table& table, ASTNode* interface, ASTAny* for_, ImplDefinition* impl) {
+        auto i = ImplementationIndexKeyHash{}(ImplementationIndexKey{ interface, for_ }) & table.mask;
+        while(table.slots[i].impl.load(std::memory_order_relaxed) != nullptr) {
+            i = (i + 1) & table.mask;
+        }
+        auto& slot = table.slots[i];
+        slot.interface.store(interface, std::memory_order_relaxed);
+        slot.for_.store(for_, std::memory_order_relaxed);
+        slot.impl.store(impl, std::memory_order_release);
+    }
+
+    /**
+     * replaces the current table with one of twice the capacity, write mutex must be held
+     */
+    Table* grow(Table* table) {
+        auto next = std::make_unique<Table>(table ? (table->mask + 1) * 2 : 64);
+        if(table) {
+            for(std::size_t i = 0; i <= table->mask; i++) {
+                auto& slot = table->slots[i];
+                const auto impl = slot.impl.load(std::memory_order_relaxed);
+                if(impl != nullptr) {
+                    put(*next, slot.interface.load(std::memory_order_relaxed), slot.for_.load(std::memory_order_relaxed), impl);
+                }
+            }
+        }
+        const auto ptr = next.get();
+        tables.emplace_back(std::move(next));
+        current.store(ptr, std::memory_order_release);
+        return ptr;
+    }
 
-    // reader-writer mutex for thread-safe concurrent reads and exclusive writes
-    mutable std::shared_mutex index_mutex;
+public:
 
+    /**
+     * adds the implementation, an existing implementation for the same key isn't replaced
+     */
     void add(ASTNode* interface, ASTAny* for_, ImplDefinition* impl) {
-        std::unique_lock lock(index_mutex);
-        map_.emplace(ImplementationIndexKey{ interface, for_ }, impl);
+        if(impl == nullptr) return;
+        std::lock_guard lock(write_mutex);
+        if(get(interface, for_) != nullptr) return;
+        auto table = current.load(std::memory_order_relaxed);
+        // keeping the load factor under a half, so probes end quickly (and always)
+        if(table == nullptr || (count + 1) * 2 > table->mask + 1) {
+            table = grow(table);
+        }
+        put(*table, interface, for_, impl);
+        count++;
+        // after the implementation is published, so a miss remembered with the new generation saw it
+        generation.store(next_generation.fetch_add(1, std::memory_order_relaxed), std::memory_order_release);
     }
 
     /**
@@ -65,20 +198,47 @@ public:
 
     void add_interface(InterfaceDefinition* interface, ASTAny* for_, ImplDefinition* impl);
 
+    /**
+     * get the implementation, this doesn't take any lock, so it can be called
+     * concurrently with other lookups and with add, misses are remembered per thread
+     */
     ImplDefinition* get(ASTNode* interface, ASTAny* for_) const {
-        std::shared_lock lock(index_mutex);
-        const auto it = map_.find(ImplementationIndexKey{ interface, for_ });
-        if(it == map_.end()) return nullptr;
-        return it->second;
+        const auto gen = generation.load(std::memory_order_acquire);
+        const auto hash = ImplementationIndexKeyHash{}(ImplementationIndexKey{ interface, for_ });
+        auto& entry = negative_cache()[hash & (NEGATIVE_CACHE_SIZE - 1)];
+        if(entry.generation == gen && entry.interface == interface && entry.for_ == for_) {
+            return nullptr;
+        }
+        const auto table = current.load(std::memory_order_acquire);
+        if(table == nullptr) return nullptr;
+        auto i = hash & table->mask;
+        while(true) {
+            auto& slot = table->slots[i];
+            const auto impl = slot.impl.load(std::memory_order_acquire);
+            if(impl == nullptr) {
+                entry = NegativeEntry{ interface, for_, gen };
+                return nullptr;
+            }
+            if(slot.interface.load(std::memory_order_relaxed) == interface && slot.for_.load(std::memory_order_relaxed) == for_) {
+                return impl;
+            }
+            i = (i + 1) & table->mask;
+        }
     }
 
     ImplDefinition* get_impl(ASTNode* interface, ASTAny* for_);
 
     ImplDefinition* get_impl(InterfaceDefinition* interface, ASTAny* for_);
 
+    /**
+     * removes all the implementations, must not be called while other threads are looking up
+     */
     void clear() {
-        std::unique_lock lock(index_mutex);
-        map_.clear();
+        std::lock_guard lock(write_mutex);
+        current.store(nullptr, std::memory_order_release);
+        tables.clear();
+        count = 0;
+        generation.store(next_generation.fetch_add(1, std::memory_order_relaxed), std::memory_order_release);
     }
 
     FunctionDeclaration* get_expr_op_impl(const CoreNodes& coreNodes, MembersContainer* container, Operation op) const;
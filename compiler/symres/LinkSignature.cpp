@@ -1244,12 +1244,7 @@ void buildContainerIndexes(MembersContainer* container) {
             // putting all index of this container
             // except we will never override, respecting already present indexes
             // because we want to support function hiding, function in container will hide function in inherited container (with same name)
-            auto& container_indexes = container->indexes;
-            auto& sub_container_indexes = sub_container->indexes;
-            container_indexes.reserve(container_indexes.size() + sub_container_indexes.size());
-            for(auto& index : sub_container_indexes) {
-                container_indexes.try_emplace(index.first, index.second);
-            }
+            container->indexes.merge(sub_container->indexes);
         }
     }
     // set indexes to built
@@ -1278,12 +1273,7 @@ void buildInterfaceIndexes(InterfaceDefinition* container) {
         // putting all indexes of this container
         // except we will never override, respecting already present indexes
         // because we want to support function hiding, function in container will hide function in inherited container (with same name)
-        auto& container_indexes = container->indexes;
-        auto& sub_container_indexes = sub_container->indexes;
-        container_indexes.reserve(container_indexes.size() + sub_container_indexes.size());
-        for(auto& index : sub_container_indexes) {
-            container_indexes.try_emplace(index.first, index.second);
-        }
+        container->indexes.merge(sub_container->indexes);
     }
     // set indexes to built
     // so we can skip building it again when other containers inherit this container
@@ -1459,12 +1449,7 @@ void build_indexes_of_impl(SymbolResolver& linker, ImplDefinition* decl) {
             }
         }
         // putting indexes of interface into impl
-        auto& container_indexes = decl->indexes;
-        auto& sub_container_indexes = interface->indexes;
-        container_indexes.reserve(container_indexes.size() + sub_container_indexes.size());
-        for(auto& index : sub_container_indexes) {
-            container_indexes.try_emplace(index.first, index.second);
-        }
+        decl->indexes.merge(interface->indexes);
     }
 }
 
@@ -168,10 +168,47 @@ void visit_generic_decl_only(SymResLinkBody& visitor, ASTNode* node) {
     }
 }
 
-SymResLinkBodyResult sym_res_link_body_pass(SymbolResolver& resolver, Scope* scope, const SymbolRange& range) {
+/**
+ * declares the using statements in the given top level node, nodes that come before a batch of the
+ * file are not visited by its visitor, so using statements in them are declared this way
+ */
+static void declare_preceding_usings(SymResLinkBody& visitor, ASTDiagnoser& diagnoser, ASTNode* node) {
+    switch (node->kind()) {
+        case ASTNodeKind::UsingStmt: {
+            const auto stmt = node->as_using_stmt();
+            if(!stmt->is_failed_chain_link()) {
+                stmt->declare_symbols(visitor.table, diagnoser);
+            }
+            return;
+        }
+        case ASTNodeKind::IfStmt: {
+            const auto stmt = node->as_if_stmt_unsafe();
+            if (node->is_top_level() && stmt->computed_scope.has_value()) {
+                const auto scope = stmt->computed_scope.value();
+                if (scope) {
+                    for (const auto child : scope->nodes) {
+                        declare_preceding_usings(visitor, diagnoser, child);
+                    }
+                }
+            }
+            return;
+        }
+        default:
+            return;
+    }
+}
+
+SymResLinkBodyResult sym_res_link_body_pass(SymbolResolver& resolver, std::span<ASTNode*> nodes, std::span<ASTNode*> preceding, const SymbolRange& range) {
     SymResLinkBody visitor(resolver);
     resolver.enable_file_symbols(visitor.table, range);
-    for (const auto node : scope->nodes) {
+    if(!preceding.empty()) {
+        // the batch that contains these using statements reports their errors
+        ASTDiagnoser preceding_diagnoser(visitor.diagnoser.loc_man);
+        for (const auto node : preceding) {
+            declare_preceding_usings(visitor, preceding_diagnoser, node);
+        }
+    }
+    for (const auto node : nodes) {
         visit_non_generic_decl_only(visitor, node);
     }
     return SymResLinkBodyResult {
@@ -180,6 +217,10 @@ SymResLinkBodyResult sym_res_link_body_pass(SymbolResolver& resolver, Scope* sco
     };
 }
 
+SymResLinkBodyResult sym_res_link_body_pass(SymbolResolver& resolver, Scope* scope, const SymbolRange& range) {
+    return sym_res_link_body_pass(resolver, scope->nodes, {}, range);
+}
+
 SymResLinkBodyResult sym_res_link_body_generic_decls_pass(SymbolResolver& resolver, Scope* scope, const SymbolRange& range) {
     SymResLinkBody visitor(resolver);
     resolver.enable_file_symbols(visitor.table, range);
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "LinkSignatureAPI.h"
+#include <span>
 
 class SymbolResolver;
 
@@ -31,4 +32,11 @@ SymResLinkBodyResult sym_res_link_body_generic_decls_pass(SymbolResolver& resolv
 /**
  * pass 2: only visit non-generic declarations in the file, skipping over all generic declarations
  */
-SymResLinkBodyResult sym_res_link_body_pass(SymbolResolver& resolver, Scope* scope, const SymbolRange& range);
\ No newline at end of file
+SymResLinkBodyResult sym_res_link_body_pass(SymbolResolver& resolver, Scope* scope, const SymbolRange& range);
+
+/**
+ * pass 2 over the given top level nodes of a file, the range is of the file's private symbols,
+ * this allows to link a large file in batches of nodes on different threads, preceding are the
+ * top level nodes of the file before the batch, using statements in them are declared first
+ */
+SymResLinkBodyResult sym_res_link_body_pass(SymbolResolver& resolver, std::span<ASTNode*> nodes, std::span<ASTNode*> preceding, const SymbolRange& range);
\ No newline at end of file
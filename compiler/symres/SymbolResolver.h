@@ -348,6 +348,14 @@ public:
      */
     void declare_or_shadow(const chem::string_view &name, ASTNode* node);
 
+    /**
+     * declare all the symbols of the layer, shadowing the previous symbols, the layer
+     * must not be changed or destroyed until the current scope ends
+     */
+    inline void declare_layer(const SymbolLayer& layer) {
+        getSymbolTable().push_layer(layer);
+    }
+
     /**
      * declare a symbol
      */
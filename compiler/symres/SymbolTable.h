@@ -54,6 +54,110 @@ struct Bucket : BucketSymbol {
     BucketSymbol* collision = nullptr; // Chain of symbols that collided (different keys).
 };
 
+/**
+ * @brief A read only table of symbols, built once and pushed on symbol tables.
+ *
+ * A symbol table consults its layers (latest first) for a symbol that hasn't been declared
+ * in the table after the layer was pushed, so pushing a layer is like declaring all of its
+ * symbols (shadowing the previous ones) without inserting them one by one, symbols declared
+ * after the push shadow the layer. Exported symbols of a module are built into a layer once
+ * and the layer is shared by all the modules that depend upon it.
+ *
+ * Symbols resolved from a layer have index -1, because they aren't entries of the table.
+ */
+class SymbolLayer {
+private:
+    std::vector<BucketSymbol> slots;    // Open addressing, a slot without a node is empty.
+    size_t count = 0;                   // Number of symbols in the layer.
+
+    /**
+     * @brief Puts the symbol in the slots, overriding the symbol with the same key.
+     *
+     * @return True if the symbol was added, false if it overrode an existing one.
+     */
+    static bool put_slot(std::vector<BucketSymbol>& target, const BucketSymbol& symbol) noexcept {
+        const auto mask = target.size() - 1;
+        auto i = symbol.hash & mask;
+        while(target[i].activeNode != nullptr) {
+            auto& slot = target[i];
+            if(slot.hash == symbol.hash && slot.key == symbol.key) {
+                slot.activeNode = symbol.activeNode;
+                return false;
+            }
+            i = (i + 1) & mask;
+        }
+        target[i] = symbol;
+        return true;
+    }
+
+    /**
+     * @brief Doubles the slots, keeping the load factor under a half.
+     */
+    void grow() {
+        std::vector<BucketSymbol> newSlots(slots.empty() ? 16 : slots.size() * 2);
+        for(auto& slot : slots) {
+            if(slot.activeNode != nullptr) {
+                put_slot(newSlots, slot);
+            }
+        }
+        slots = std::move(newSlots);
+    }
+
+public:
+
+    /**
+     * @brief Declares the symbol in the layer, shadowing the symbol with the same key.
+     *
+     * Must not be called after the layer has been pushed on a symbol table.
+     */
+    void declare(const chem::string_view& key, ASTNode* const node) {
+        if((count + 1) * 2 > slots.size()) {
+            grow();
+        }
+        // same hash as the symbol table
+        const auto hash = std::hash<chem::string_view>{}(key);
+        if(put_slot(slots, BucketSymbol{ key, hash, node, -1, nullptr })) {
+            count++;
+        }
+    }
+
+    /**
+     * @brief Resolves the symbol with the given key and its precomputed hash.
+     *
+     * @return Pointer to the symbol, or nullptr if not found.
+     */
+    const BucketSymbol* resolve_bucket(const chem::string_view& key, const size_t hash) const noexcept {
+        if(count == 0) return nullptr;
+        const auto mask = slots.size() - 1;
+        auto i = hash & mask;
+        while(slots[i].activeNode != nullptr) {
+            auto& slot = slots[i];
+            if(slot.hash == hash && slot.key == key) {
+                return &slot;
+            }
+            i = (i + 1) & mask;
+        }
+        return nullptr;
+    }
+
+    /**
+     * the number of symbols in the layer
+     */
+    inline size_t size() const noexcept {
+        return count;
+    }
+
+};
+
+/**
+ * @brief A layer pushed on the symbol table.
+ */
+struct SymbolLayerEntry {
+    const SymbolLayer* layer;   // The layer, must outlive the scope it was pushed in.
+    unsigned long start;        // The index in the symbols vector where the layer was pushed.
+    unsigned long depth;        // The number of scopes when the layer was pushed.
+};
+
 /**
  * @brief Represents a lexical scope.
  *
@@ -86,6 +190,7 @@ private:
     std::vector<Bucket> buckets;           // Hash table: an array of buckets.
     size_t bucketMask;                     // Mask used for fast modulo (buckets.size() is a power of two).
     std::vector<SymbolScope> scopeStack;   // Stack of scopes for managing declarations.
+    std::vector<SymbolLayerEntry> layers;  // Layers consulted on a miss, in order of push.
 
     // --- Custom Memory Pool for BucketSymbol Objects ---
     // Instead of allocating one BucketSymbol at a time, we allocate them in blocks.
@@ -221,6 +326,47 @@ private:
         }
     }
 
+    /**
+     * @brief Finds the active symbol with the given key in the buckets (not the layers).
+     */
+    const BucketSymbol* find_bucket(const chem::string_view& key, const size_t hash) const noexcept {
+        const Bucket &bucket = buckets[hash & bucketMask];
+        if (bucket.index != -1 && bucket.hash == hash && bucket.key == key)
+            return &bucket;
+        // Scan collision chain even if bucket index is -1.
+        BucketSymbol* sym = bucket.collision;
+        while (sym) {
+            if (sym->hash == hash && sym->key == key)
+                return sym;
+            sym = sym->next;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Resolves the key in the layers pushed after the given symbol was declared.
+     *
+     * @param found The symbol found in the buckets, nullptr if not found.
+     * @return The symbol in the latest such layer, or the given symbol if no layer has the key.
+     */
+    const BucketSymbol* resolve_in_layers(const chem::string_view& key, const size_t hash, const BucketSymbol* found) const noexcept {
+        const long index = found ? found->index : -1;
+        for (auto it = layers.rbegin(); it != layers.rend() && static_cast<long>(it->start) > index; ++it) {
+            const auto sym = it->layer->resolve_bucket(key, hash);
+            if (sym) return sym;
+        }
+        return found;
+    }
+
+    /**
+     * @brief Drops the layers pushed in scopes that have ended.
+     */
+    inline void drop_ended_layers() noexcept {
+        while (!layers.empty() && layers.back().depth > scopeStack.size()) {
+            layers.pop_back();
+        }
+    }
+
     /**
      * @brief Rehashes the bucket array when load factor exceeds threshold.
      *
@@ -286,6 +432,7 @@ public:
         , buckets(std::move(other.buckets))
         , bucketMask(other.bucketMask)
         , scopeStack(std::move(other.scopeStack))
+        , layers(std::move(other.layers))
         , bucketSymbolBlocks(std::move(other.bucketSymbolBlocks))
         , currentBlock(other.currentBlock)
         , currentBlockOffset(other.currentBlockOffset)
@@ -310,6 +457,7 @@ public:
             buckets = std::move(other.buckets);
             bucketMask = other.bucketMask;
             scopeStack = std::move(other.scopeStack);
+            layers = std::move(other.layers);
             bucketSymbolBlocks = std::move(other.bucketSymbolBlocks);
             currentBlock = other.currentBlock;
             currentBlockOffset = other.currentBlockOffset;
@@ -440,6 +588,11 @@ public:
         }
 
         const auto hash = computeHash(key);
+        if (!layers.empty()) {
+            // the symbol may be declared in a layer, or shadowed by one
+            const auto visible = resolve_in_layers(key, hash, find_bucket(key, hash));
+            if (visible) return visible;
+        }
         const auto bucketIndex = hash & bucketMask;
         Bucket &bucket = buckets[bucketIndex];
 
@@ -490,7 +643,8 @@ public:
      * @return True if the symbol's index is within the current scope; false otherwise.
      */
     inline bool is_in_current_scope(const BucketSymbol* symbol) const noexcept {
-        return symbol->index >= scopeStack.back().start;
+        // symbols of layers (index -1) aren't entries of any scope
+        return symbol->index >= 0 && static_cast<unsigned long>(symbol->index) >= scopeStack.back().start;
     }
 
     /**
@@ -502,20 +656,10 @@ public:
      * @param key The symbol key.
      * @return Pointer to the bucket symbol,
      */
-    const BucketSymbol* resolve_bucket(const chem::string_view& key) {
-        size_t hash = computeHash(key);
-        size_t bucketIndex = hash & bucketMask;
-        const Bucket &bucket = buckets[bucketIndex];
-        if (bucket.index != -1 && bucket.hash == hash && bucket.key == key)
-            return &bucket;
-        // Scan collision chain even if bucket index is -1.
-        BucketSymbol* sym = bucket.collision;
-        while (sym) {
-            if (sym->hash == hash && sym->key == key)
-                return sym;
-            sym = sym->next;
-        }
-        return nullptr;
+    const BucketSymbol* resolve_bucket(const chem::string_view& key) const noexcept {
+        const auto hash = computeHash(key);
+        const auto found = find_bucket(key, hash);
+        return layers.empty() ? found : resolve_in_layers(key, hash, found);
     }
 
     /**
@@ -528,19 +672,20 @@ public:
      * @return Pointer to the associated AST node if found, or nullptr if not found.
      */
     ASTNode* resolve(const chem::string_view& key) const noexcept {
-        size_t hash = computeHash(key);
-        size_t bucketIndex = hash & bucketMask;
-        const Bucket &bucket = buckets[bucketIndex];
-        if (bucket.index != -1 && bucket.hash == hash && bucket.key == key)
-            return bucket.activeNode;
-        // Scan collision chain even if bucket index is -1.
-        BucketSymbol* sym = bucket.collision;
-        while (sym) {
-            if (sym->hash == hash && sym->key == key)
-                return sym->activeNode;
-            sym = sym->next;
-        }
-        return nullptr;
+        const auto sym = resolve_bucket(key);
+        return sym ? sym->activeNode : nullptr;
+    }
+
+    /**
+     * @brief Pushes the layer in the current scope.
+     *
+     * Its symbols become visible (shadowing the symbols declared before) until the
+     * current scope ends, the layer must not be changed or destroyed until then.
+     */
+    inline void push_layer(const SymbolLayer& layer) {
+        assert(!scopeStack.empty());
+        if (layer.size() == 0) return;
+        layers.push_back(SymbolLayerEntry{ &layer, static_cast<unsigned long>(symbols.size()), static_cast<unsigned long>(scopeStack.size()) });
     }
 
     /**
@@ -714,6 +859,7 @@ public:
         assert(scope_index < scopeStack.size());
         auto marker = scopeStack[scope_index].start;
         scopeStack.resize(scope_index);
+        drop_ended_layers();
         drop_symbols_from(marker);
         symbols.resize(marker);
     }
@@ -727,6 +873,7 @@ public:
         assert(!scopeStack.empty());
         auto marker = scopeStack.back().start;
         scopeStack.pop_back();
+        drop_ended_layers();
         drop_symbols_from(marker);
         symbols.resize(marker);
     }
@@ -738,6 +885,7 @@ public:
     void clear() {
         symbols.clear();
         scopeStack.clear();
+        layers.clear();
         for (auto block : bucketSymbolBlocks) {
             ::operator delete(block, std::align_val_t(alignof(BucketSymbol)));
         }
@@ -3,6 +3,27 @@
 #include "LocationManager.h"
 #include "std/except.h"
 
+LocationManager::~LocationManager() {
+    for(auto& segment : segments) {
+        delete[] segment.load(std::memory_order_relaxed);
+    }
+}
+
+LocationManager::LocationData* LocationManager::get_or_create_segment(unsigned int segment) {
+    auto& slot = segments[segment];
+    auto existing = slot.load(std::memory_order_acquire);
+    if(existing) {
+        return existing;
+    }
+    // multiple threads may race to allocate the same segment, only one of them wins
+    const auto created = new LocationData[1ULL << (FIRST_SEGMENT_BITS + segment)];
+    if(slot.compare_exchange_strong(existing, created, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return created;
+    }
+    delete[] created;
+    return existing;
+}
+
 unsigned int LocationManager::encodeFile(const std::string& filePath) {
     std::lock_guard guard(file_mutex);
     auto itr = file_paths.find(filePath);
@@ -50,11 +71,11 @@ uint64_t LocationManager::addLocation(uint32_t fileId, uint32_t lineStart, uint3
             fileId <= MAX_FILE_ID &&
             lineStart <= MAX_LINE_START &&
             charStart <= MAX_CHAR_START &&
-            (lineEnd - lineEnd) <= MAX_LINE_END_OFFSET &&
+            (lineEnd - lineStart) <= MAX_LINE_END_OFFSET &&
             charEnd <= MAX_CHAR_END
     ) {
 #ifdef DEBUG
-        if(lineEnd < lineStart || (lineEnd - lineStart) >= MAX_LINE_END_OFFSET) {
+        if(lineEnd < lineStart || (lineEnd - lineStart) > MAX_LINE_END_OFFSET) {
             CHEM_THROW_RUNTIME("invalid line end provided to the addLocation");
         }
 #endif
@@ -66,10 +87,16 @@ uint64_t LocationManager::addLocation(uint32_t fileId, uint32_t lineStart, uint3
         location |= static_cast<uint64_t>(charEnd);
         return location;
     } else {
-        std::lock_guard guard(location_mutex);
-        // Store in vector if it doesn't fit
-        uint64_t index = locations.size();
-        locations.emplace_back(fileId, lineStart, charStart, lineEnd, charEnd);
+        // Store in segments if it doesn't fit
+        const auto index = overflow_count.fetch_add(1, std::memory_order_relaxed);
+        unsigned int segment;
+        uint64_t offset;
+        overflow_position(index, segment, offset);
+        if(segment >= MAX_SEGMENTS) {
+            CHEM_THROW_RUNTIME("too many locations that can't be encoded");
+        }
+        // the encoded index reaches readers through the ast, which is handed across threads with synchronization
+        get_or_create_segment(segment)[offset] = LocationData { fileId, lineStart, charStart, lineEnd, charEnd };
         return INDICATOR_BIT_MASK | index; // Mark as an index with the indicator bit
     }
 }
@@ -79,11 +106,14 @@ uint32_t LocationManager::getLineStartFast(SourceLocation loc) {
     if (data & INDICATOR_BIT_MASK) { // Indicator bit check
         uint64_t index = data & NOT_INDICATOR_BIT_MASK;
 #ifdef DEBUG
-        if (index >= locations.size()) {
+        if (index >= overflow_count.load(std::memory_order_relaxed)) {
             CHEM_THROW_RUNTIME("Location index out of range.");
         }
 #endif
-        return locations[index].lineStart;
+        unsigned int segment;
+        uint64_t offset;
+        overflow_position(index, segment, offset);
+        return segments[segment].load(std::memory_order_acquire)[offset].lineStart;
     } else {
         return (data >> (LINE_START_SHIFT_BITS)) & MAX_LINE_START;
     }
@@ -93,11 +123,14 @@ LocationManager::LocationData LocationManager::getLocation(uint64_t data) const
     if (data & INDICATOR_BIT_MASK) { // Indicator bit check
         uint64_t index = data & NOT_INDICATOR_BIT_MASK;
 #ifdef DEBUG
-        if (index >= locations.size()) {
+        if (index >= overflow_count.load(std::memory_order_relaxed)) {
             CHEM_THROW_RUNTIME("Location index out of range.");
         }
 #endif
-        return locations[index];
+        unsigned int segment;
+        uint64_t offset;
+        overflow_position(index, segment, offset);
+        return segments[segment].load(std::memory_order_acquire)[offset];
     } else {
         const auto lineStart = (data >> (LINE_START_SHIFT_BITS)) & MAX_LINE_START;
         return LocationManager::LocationData {
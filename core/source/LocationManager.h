@@ -3,10 +3,12 @@
 #pragma once
 
 #include <vector>
+#include <bit>
 #include "SourceLocation.h"
 #include "core/diag/Position.h"
 #include "ordered_map.h"
 #include <mutex>
+#include <atomic>
 
 class LocationManager {
 public:
@@ -27,13 +29,30 @@ public:
 
 private:
 
+    /**
+     * the first overflow segment holds (1 << FIRST_SEGMENT_BITS) locations, every next
+     * segment holds twice as many as the one before it
+     */
+    static constexpr unsigned int FIRST_SEGMENT_BITS = 8;
+
+    /**
+     * maximum segments, total capacity is (1 << (FIRST_SEGMENT_BITS + MAX_SEGMENTS)) locations
+     */
+    static constexpr unsigned int MAX_SEGMENTS = 32;
+
     /**
      * locations that are too large and cannot be stored in 63 bits
-     * we store those locations on this vector and an index is of 63 bits
+     * we store those locations in these segments and an index is of 63 bits
      * is provided to the user where the most significant bit is set to 1 to indicate
-     * it's an index
+     * it's an index, segments are allocated once and never moved, so indexes remain
+     * valid and locations can be appended and read concurrently without a lock
      */
-    std::vector<LocationData> locations;
+    std::atomic<LocationData*> segments[MAX_SEGMENTS] = {};
+
+    /**
+     * the number of locations stored in the segments, incremented to reserve an index
+     */
+    std::atomic<uint64_t> overflow_count = 0;
 
     /**
      * the file paths are stored on this ordered map, to only store a single instance of the
@@ -48,19 +67,39 @@ private:
     std::mutex file_mutex;
 
     /**
-     * the mutex is used when adding locations because
-     * locations can be added concurrently, only large locations use the mutex
-     * other are encoded concurrently
+     * get the segment and offset inside the segment for the given overflow index
      */
-    std::mutex location_mutex;
+    static inline void overflow_position(uint64_t index, unsigned int& segment, uint64_t& offset) {
+        const auto biased = index + (1ULL << FIRST_SEGMENT_BITS);
+        const auto top_bit = 63u - static_cast<unsigned int>(std::countl_zero(biased));
+        segment = top_bit - FIRST_SEGMENT_BITS;
+        offset = biased - (1ULL << top_bit);
+    }
+
+    /**
+     * get the segment at given index, allocating it if it doesn't exist
+     */
+    LocationData* get_or_create_segment(unsigned int segment);
 
 public:
 
+    /**
+     * constructor
+     */
+    LocationManager() = default;
+
+    /**
+     * destructor, frees the overflow segments
+     */
+    ~LocationManager();
+
     // Bit allocations and maximum values for validation
-    static constexpr uint32_t FILE_ID_BITS = 10;
-    static constexpr uint32_t LINE_START_BITS = 18;
+    // file ids get more bits than lines and columns, because projects with thousands of
+    // files are common, while lines over 131071 and nodes spanning 511 lines are rare
+    static constexpr uint32_t FILE_ID_BITS = 13;
+    static constexpr uint32_t LINE_START_BITS = 17;
     static constexpr uint32_t CHAR_START_BITS = 12;
-    static constexpr uint32_t LINE_END_OFFSET_BITS = 11;
+    static constexpr uint32_t LINE_END_OFFSET_BITS = 9;
     static constexpr uint32_t CHAR_END_BITS = 12;
 
     static constexpr uint32_t MAX_FILE_ID = (1U << FILE_ID_BITS) - 1;
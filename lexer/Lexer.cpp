@@ -1,11 +1,18 @@
 // Copyright (c) Chemical Language Foundation 2025.
 
 #include "Lexer.h"
-#include <unordered_map>
+#include <bit>
+#include <cstdint>
+#include <cstring>
 #include "utils/StringHelpers.h"
 #include "compiler/cbi/model/CompilerBinder.h"
 #include "std/except.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LEXER_SSE2_SCAN
+#endif
+
 const auto EmptyCStr = "";
 const auto LBraceCStr = "{";
 const auto RBraceCStr = "}";
@@ -59,8 +66,12 @@ constexpr chem::string_view view_str(const char* c_str) {
     return { c_str };
 }
 
-const std::unordered_map<chem::string_view, TokenType> keywords = {
-        {
+struct KeywordEntry {
+    chem::string_view name;
+    TokenType type;
+};
+
+const constexpr KeywordEntry keywords_list[] = {
 
                 // Local Level Statements
                 { "for", TokenType::ForKw },
@@ -177,9 +188,77 @@ const std::unordered_map<chem::string_view, TokenType> keywords = {
                 { "zeroed", TokenType::ZeroedKw },
                 { "const", TokenType::ConstKw },
                 { "where", TokenType::WhereKw },
-        }
 };
 
+/**
+ * keywords are looked up in a perfect hash table, the key is made of first two characters,
+ * last two characters and the length of the identifier, the multiplier was searched so that
+ * no two keywords land in the same slot (checked when the table is built at compile time)
+ */
+constexpr unsigned int keyword_hash_bits = 9;
+constexpr uint64_t keyword_hash_multiplier = 0x6c86019e4c5a0fULL;
+
+/**
+ * identifiers outside these lengths can't be keywords, also keeps the hash from reading outside
+ */
+constexpr std::size_t keyword_min_length = 2;
+constexpr std::size_t keyword_max_length = 11;
+
+constexpr unsigned int keyword_slot(const char* data, std::size_t size) {
+    const auto key = static_cast<uint64_t>(static_cast<unsigned char>(data[0]))
+            | (static_cast<uint64_t>(static_cast<unsigned char>(data[1])) << 8)
+            | (static_cast<uint64_t>(static_cast<unsigned char>(data[size - 2])) << 16)
+            | (static_cast<uint64_t>(static_cast<unsigned char>(data[size - 1])) << 24)
+            | (static_cast<uint64_t>(size) << 32);
+    return static_cast<unsigned int>((key * keyword_hash_multiplier) >> (64 - keyword_hash_bits));
+}
+
+struct KeywordTable {
+    // empty slots have a name of size zero
+    KeywordEntry slots[1u << keyword_hash_bits];
+    // a keyword has a length outside the hashed range
+    bool length_out_of_range = false;
+    // two keywords landed in the same slot
+    bool collision = false;
+};
+
+constexpr KeywordTable make_keyword_table() {
+    KeywordTable table{};
+    for(auto& keyword : keywords_list) {
+        if(keyword.name.size() < keyword_min_length || keyword.name.size() > keyword_max_length) {
+            table.length_out_of_range = true;
+            continue;
+        }
+        auto& slot = table.slots[keyword_slot(keyword.name.data(), keyword.name.size())];
+        if(!slot.name.empty()) {
+            table.collision = true;
+            continue;
+        }
+        slot = keyword;
+    }
+    return table;
+}
+
+constexpr KeywordTable keywords = make_keyword_table();
+
+static_assert(!keywords.length_out_of_range, "keyword length out of the hashed range, update keyword_min_length / keyword_max_length");
+static_assert(!keywords.collision, "keywords collide in the perfect hash, search a new keyword_hash_multiplier");
+
+/**
+ * returns the keyword entry for the given identifier, nullptr if its not a keyword
+ */
+inline const KeywordEntry* find_keyword(const chem::string_view& view) {
+    const auto size = view.size();
+    if(size < keyword_min_length || size > keyword_max_length) {
+        return nullptr;
+    }
+    const auto& entry = keywords.slots[keyword_slot(view.data(), size)];
+    if(entry.name.size() == size && std::memcmp(entry.name.data(), view.data(), size) == 0) {
+        return &entry;
+    }
+    return nullptr;
+}
+
 inline chem::string_view view_from(SourceProvider& provider, const char* data) {
     return { data, static_cast<std::size_t>(provider.current_data() - data) };
 }
@@ -475,19 +554,107 @@ void read_zero_starting_number(SourceProvider& provider) {
     return read_number(provider);
 }
 
-void read_current_line(SourceProvider& provider) {
-    while(true) {
-        auto p = provider.peek();
-        if(p != '\0' && p != '\n' && p != '\r') {
-            provider.increment();
-        } else {
-            return;
+// ---------- bulk scanning of character runs ----------
+// identifiers, whitespace and comments make up most of the source, these return the length
+// of the run starting at p, scanning 16 bytes at a time when SSE2 is available
+
+static inline bool is_ascii_identifier_byte(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// characters at which comment runs stop
+static inline bool is_comment_run_end(unsigned char c, bool multi_line) {
+    return c == '\n' || c == '\r' || c == '\0' || (multi_line && c == '*');
+}
+
+#ifdef LEXER_SSE2_SCAN
+
+// bytes of x in the (unsigned) range [lo, hi] are set to 0xFF
+static inline __m128i bytes_in_range(__m128i x, char lo, char hi) {
+    const auto ge_lo = _mm_cmpeq_epi8(_mm_max_epu8(x, _mm_set1_epi8(lo)), x);
+    const auto le_hi = _mm_cmpeq_epi8(_mm_min_epu8(x, _mm_set1_epi8(hi)), x);
+    return _mm_and_si128(ge_lo, le_hi);
+}
+
+static inline unsigned int identifier_mask(__m128i x) {
+    // setting 0x20 folds upper case to lower case, no other byte lands in a-z
+    const auto letters = bytes_in_range(_mm_or_si128(x, _mm_set1_epi8(0x20)), 'a', 'z');
+    const auto digits = bytes_in_range(x, '0', '9');
+    const auto underscore = _mm_cmpeq_epi8(x, _mm_set1_epi8('_'));
+    return static_cast<unsigned int>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letters, digits), underscore)));
+}
+
+static inline unsigned int blank_mask(__m128i x) {
+    const auto spaces = _mm_cmpeq_epi8(x, _mm_set1_epi8(' '));
+    const auto tabs = _mm_cmpeq_epi8(x, _mm_set1_epi8('\t'));
+    return static_cast<unsigned int>(_mm_movemask_epi8(_mm_or_si128(spaces, tabs)));
+}
+
+static inline unsigned int comment_mask(__m128i x, bool multi_line) {
+    auto stops = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(x, _mm_set1_epi8('\r'))),
+            _mm_cmpeq_epi8(x, _mm_setzero_si128())
+    );
+    if(multi_line) {
+        stops = _mm_or_si128(stops, _mm_cmpeq_epi8(x, _mm_set1_epi8('*')));
+    }
+    // the mask has bits set for bytes that continue the run
+    return ~static_cast<unsigned int>(_mm_movemask_epi8(stops)) & 0xFFFFu;
+}
+
+#endif
+
+template<typename VectorMask, typename ScalarPred>
+static inline std::size_t scan_run(const char* p, const char* end, VectorMask vector_mask, ScalarPred scalar_pred) {
+    const auto start = p;
+#ifdef LEXER_SSE2_SCAN
+    while(end - p >= 16) {
+        const auto mask = vector_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+        if(mask != 0xFFFFu) {
+            return static_cast<std::size_t>(p - start) + std::countr_one(mask);
         }
+        p += 16;
+    }
+#endif
+    while(p != end && scalar_pred(static_cast<unsigned char>(*p))) {
+        p++;
     }
+    return static_cast<std::size_t>(p - start);
+}
+
+static inline std::size_t identifier_run(const char* p, const char* end) {
+#ifdef LEXER_SSE2_SCAN
+    return scan_run(p, end, identifier_mask, is_ascii_identifier_byte);
+#else
+    return scan_run(p, end, nullptr, is_ascii_identifier_byte);
+#endif
+}
+
+static inline std::size_t blank_run(const char* p, const char* end) {
+    const auto is_blank = [](unsigned char c) { return c == ' ' || c == '\t'; };
+#ifdef LEXER_SSE2_SCAN
+    return scan_run(p, end, blank_mask, is_blank);
+#else
+    return scan_run(p, end, nullptr, is_blank);
+#endif
+}
+
+static inline std::size_t comment_run(const char* p, const char* end, bool multi_line) {
+    const auto continues = [multi_line](unsigned char c) { return !is_comment_run_end(c, multi_line); };
+#ifdef LEXER_SSE2_SCAN
+    return scan_run(p, end, [multi_line](__m128i x) { return comment_mask(x, multi_line); }, continues);
+#else
+    return scan_run(p, end, nullptr, continues);
+#endif
+}
+
+void read_current_line(SourceProvider& provider) {
+    provider.advance(comment_run(provider.current_data(), provider.end_data(), false));
 }
 
 const char* read_multi_line_comment_text(SourceProvider& provider) {
     while(true) {
+        provider.advance(comment_run(provider.current_data(), provider.end_data(), true));
         const auto read = provider.readCharacter();
         if(read == '\0') {
             return provider.current_data();
@@ -711,8 +878,10 @@ bool read_char_in_quotes(SourceProvider& provider) {
 void read_id(SourceProvider& provider) {
     std::size_t len;
     while(true) {
+        // ascii part of the identifier is consumed in bulk, only non ascii code points are decoded
+        provider.advance(identifier_run(provider.current_data(), provider.end_data()));
         auto cp = provider.utf8_decode_peek(len);
-        if(cp != 0u && isIdentifierContinue(cp)) {
+        if(cp >= 0x80 && isIdentifierContinue(cp)) {
             provider.incrementCodepoint(cp, len);
         } else {
             return;
@@ -873,7 +1042,8 @@ Token Lexer::getNextToken() {
             read_annotation_id(provider);
             auto hashed_view = view_from(provider, curr_data_ptr);
             auto view = chem::string_view((hashed_view.data() + 1), hashed_view.size() - 1);
-            auto found = binder->findHook(view, CBIFunctionType::InitializeLexer);
+            // without a binder cbi is disabled, the macro is only tokenized
+            auto found = binder ? binder->findHook(view, CBIFunctionType::InitializeLexer) : nullptr;
             if(found) {
                 ((EmbeddedLexerInitializeFn) found)(this);
             }
@@ -1035,7 +1205,7 @@ Token Lexer::getNextToken() {
         case ' ':
         case '\t':
             // skip the whitespace
-            provider.skipWhitespaces();
+            provider.advance(blank_run(provider.current_data(), provider.end_data()));
             if(lex_whitespace) {
                 return Token(TokenType::Whitespace, { curr_data_ptr, (unsigned long long) (provider.current_data() - curr_data_ptr) }, pos);
             }
@@ -1056,9 +1226,9 @@ Token Lexer::getNextToken() {
     } else if(isIdentifierStart(cp)) {
         read_id(provider);
         auto view = view_from(provider, curr_data_ptr);
-        auto found = keywords.find(view);
-        if(found != keywords.end()) {
-            return Token(found->second, found->first, pos);
+        const auto found = find_keyword(view);
+        if(found != nullptr) {
+            return Token(found->type, found->name, pos);
         } else {
             return Token(TokenType::Identifier, view, pos);
         }
@@ -1086,8 +1256,19 @@ void to_string(chem::string& strOut, std::vector<Token>& tokens) {
     }
 }
 
+/**
+ * estimates number of tokens in the remaining source, files in lang/libs have a median of
+ * five bytes per token (p10 3.7, p90 11), four is used so that most files don't have to regrow
+ * the vector, comment heavy files over reserve, which costs 13% more capacity than growing on
+ * demand in total (see bench/TokenBufferBench.cpp)
+ */
+static inline std::size_t estimate_token_count(SourceProvider& provider) {
+    const auto remaining = static_cast<std::size_t>(provider.end_data() - provider.current_data());
+    return remaining / 4 + 1;
+}
+
 void Lexer::getTokens(std::vector<Token>& tokens) {
-    tokens.reserve(250);
+    tokens.reserve(tokens.size() + estimate_token_count(provider));
     while(true) {
         auto token = getNextToken();
         switch(token.type) {
@@ -67,7 +67,7 @@ void Parser::parseTopLevelMultipleImportStatements(ASTAllocator& allocator, std:
     }
 }
 
-void Parser::parseTopLevelMultipleStatements(ASTAllocator& allocator, std::vector<ASTNode*>& nodes, bool break_at_no_stmt) {
+void Parser::parseTopLevelMultipleStatements(ASTAllocator& allocator, std::vector<ASTNode*>& nodes, bool break_at_no_stmt, std::vector<Token*>* ends) {
 
     // lex whitespace and new lines to reach a statement
     // lex a statement and then optional whitespace, lex semicolon
@@ -88,6 +88,9 @@ void Parser::parseTopLevelMultipleStatements(ASTAllocator& allocator, std::vecto
             }
         }
         consumeToken(TokenType::SemiColonSym);
+        if(stmt && ends) {
+            ends->emplace_back(token);
+        }
     }
 }
 
@@ -95,6 +98,10 @@ void Parser::parse(std::vector<ASTNode*>& nodes) {
     parseTopLevelMultipleStatements(global_allocator, nodes);
 }
 
+void Parser::parse(std::vector<ASTNode*>& nodes, std::vector<Token*>& ends) {
+    parseTopLevelMultipleStatements(global_allocator, nodes, false, &ends);
+}
+
 Value* Parser::getErroredValue(ASTAllocator& allocator) {
     return new (allocator.allocate<NullValue>()) NullValue(typeBuilder.getNullPtrType(), loc_single(token));
 }
@@ -458,6 +458,12 @@ public:
      */
     void parse(std::vector<ASTNode*>& nodes);
 
+    /**
+     * parses nodes into the given vector, for every parsed top level node, the token after
+     * it is put into ends, the lsp uses these to re-parse only the nodes after an edit
+     */
+    void parse(std::vector<ASTNode*>& nodes, std::vector<Token*>& ends);
+
     // ------------- Functions exposed to chemical begin here
 
 public:
@@ -767,7 +773,7 @@ public:
      * functions, structs, interfaces, implementations
      * comments, variable initialization with value, constants
      */
-    void parseTopLevelMultipleStatements(ASTAllocator& allocator, std::vector<ASTNode*>& nodes, bool break_at_no_stmt = false);
+    void parseTopLevelMultipleStatements(ASTAllocator& allocator, std::vector<ASTNode*>& nodes, bool break_at_no_stmt = false, std::vector<Token*>* ends = nullptr);
 
     /**
      * All import statements defined at top level will be parseed
@@ -5,6 +5,8 @@
 #include <ostream>
 #include <iostream>
 #include <cstdint>
+#include <charconv>
+#include <cstring>
 #include "compiler/cbi/model/CompilerBinder.h"
 #include "compiler/mangler/NameMangler.h"
 #include "compiler/symres/CoreNodes.h"
@@ -143,9 +145,9 @@ ToCAstVisitor::ToCAstVisitor(
     ImplementationsIndex& implsIndex,
     bool debug_info,
     bool minify
-) : binder(binder), comptime_scope(scope), mangler(mangler), allocator(allocator), tld(*this),
-    destructor(*this), loc_man(manager), line_directives(debug_info), minify(minify),
-    ASTDiagnoser(manager), coreNodes(coreNodes), implsIndex(implsIndex)
+) : ASTDiagnoser(manager), loc_man(manager), comptime_scope(scope), mangler(mangler), binder(binder),
+    coreNodes(coreNodes), implsIndex(implsIndex), line_directives(debug_info), minify(minify), tld(*this),
+    destructor(*this), allocator(allocator), names_allocator(10000)
 {
 
 }
@@ -796,11 +798,11 @@ bool write_value_for_ref_with_val_type(ToCAstVisitor& visitor, Value* val, BaseT
         visitor.write("({ ");
         visitor.visit(value_type);
         visitor.write(' ');
-        visitor.write_str(temp_var);
+        visitor.write(temp_var);
         visitor.write(" = ");
         visitor.visit(val);
         visitor.write("; &");
-        visitor.write_str(temp_var);
+        visitor.write(temp_var);
         visitor.write("; })");
         return true;
     } else if(!is_value_param_pointer_like(val)){
@@ -816,7 +818,9 @@ inline bool write_value_for_ref_type(ToCAstVisitor& visitor, Value* val, Referen
 
 /**
  * evaluates the given comptime function call and returns its evaluated value.
- * the returned value of a %runtime_value / %runtime_block_value is fully
+ * a call to a pure function with literal arguments is looked up in the job's
+ * comptime memo first, a cached literal result is copied instead of evaluating
+ * the function again. the returned value of a %runtime_value / %runtime_block_value is fully
  * self-contained: when it was returned (set_return), evaluated_value created
  * an evaluated copy of the runtime value (evaluating the comptime variables
  * captured from the function's scope into the copy's refs), so it can be
@@ -827,6 +831,14 @@ Value* evaluate_comptime_func(
         FunctionDeclaration* func_decl,
         FunctionCall* call
 ) {
+    // pure calls with constant arguments are evaluated once in the job
+    auto& memo = *visitor.comptime_scope.memo;
+    std::string memo_key;
+    const auto memoize = memo.make_key(func_decl, call, memo_key);
+    if(memoize) {
+        const auto cached = memo.find(memo_key, visitor.allocator, visitor.comptime_scope.typeBuilder, call->encoded_location());
+        if(cached) return cached;
+    }
     const auto prev = visitor.comptime_scope.current_func_type;
     visitor.comptime_scope.current_func_type = visitor.current_func_type;
     const auto prev_runtime_call = visitor.comptime_scope.is_runtime_call;
@@ -836,6 +848,10 @@ Value* evaluate_comptime_func(
     visitor.comptime_scope.current_func_type = prev;
     // put all diagnostics for this function inside the diagnoser
     auto& diags = visitor.comptime_scope.diagnostics;
+    // calls that report diagnostics are evaluated again, to report them at every call site
+    if(memoize && value && diags.empty()) {
+        memo.put(memo_key, value);
+    }
     visitor.diagnostics.insert(visitor.diagnostics.end(), diags.begin(), diags.end());
     visitor.comptime_scope.reset_diagnostics();
     if(!value) {
@@ -874,7 +890,7 @@ void call_implicit_constructor_with_name(ToCAstVisitor& visitor, FunctionDeclara
 
 void call_implicit_constructor(ToCAstVisitor& visitor, FunctionDeclaration* imp_constructor, Value* value, bool take_addr) {
     const auto temp_name = visitor.get_local_temp_var_name();
-    call_implicit_constructor_with_name(visitor, imp_constructor, value, take_addr, chem::string_view(temp_name.data(), temp_name.size()));
+    call_implicit_constructor_with_name(visitor, imp_constructor, value, take_addr, temp_name.view());
 }
 
 VariableIdentifier* get_single_id(Value* value) {
@@ -1117,8 +1133,8 @@ void func_call_single_arg(
         ToCAstVisitor& visitor,
         BaseType* non_canon_param_type,
         Value* val,
-        std::string& temp_struct_name,
-        std::string& d_ref_name
+        TempVarName& temp_struct_name,
+        chem::string_view& d_ref_name
 ) {
 
     bool is_destructible_ref = false;
@@ -1132,7 +1148,7 @@ void func_call_single_arg(
             if(found_ref != visitor.local_allocated.end()) {
                 is_destructible_ref = true;
                 visitor.write("({ ");
-                visitor.write_str(found_ref->second);
+                visitor.write(found_ref->second);
                 visitor.write(" = ");
                 d_ref_name = found_ref->second;
             }
@@ -1205,7 +1221,7 @@ void func_call_single_arg(
 
     if(is_destructible_ref) {
         visitor.write("; ");
-        visitor.write_str(d_ref_name);
+        visitor.write(d_ref_name);
         visitor.write("; })");
     }
 
@@ -1216,8 +1232,8 @@ void func_call_single_arg_w_imp_cons(
         ToCAstVisitor& visitor,
         FunctionParam* param,
         Value* val,
-        std::string& temp_struct_name,
-        std::string& d_ref_name
+        TempVarName& temp_struct_name,
+        chem::string_view& d_ref_name
 ) {
     const auto imp_cons = param->type->implicit_constructor_for(val);
     if(imp_cons) {
@@ -1241,8 +1257,8 @@ void func_call_single_arg_w_imp_cons(
 void func_call_args(ToCAstVisitor& visitor, FunctionCall* call, FunctionType* func_type, bool& has_value_before, unsigned i) {
     auto prev_value = visitor.nested_value;
     visitor.nested_value = true;
-    std::string temp_struct_name;
-    std::string d_ref_name;
+    TempVarName temp_struct_name;
+    chem::string_view d_ref_name;
     const auto total_args = call->values.size();
     while(i < total_args) {
 
@@ -1513,7 +1529,7 @@ void allocate_fat_pointer_for_value(ToCAstVisitor& visitor, Value* value, const
         // already allocated
         return;
     }
-    visitor.local_allocated[value] = name.str();
+    visitor.local_allocated[value] = visitor.store_name(name);
     allocate_fat_pointer_by_name(visitor, name, initializer);
 }
 
@@ -1523,7 +1539,7 @@ void allocate_struct_for_value(ToCAstVisitor& visitor, ExtendableMembersContaine
         // already allocated
         return;
     }
-    visitor.local_allocated[value] = name.str();
+    visitor.local_allocated[value] = visitor.store_name(name);
     allocate_struct_by_name(visitor, def, name, initializer);
 }
 
@@ -1535,9 +1551,9 @@ void allocate_struct_for_func_call(ToCAstVisitor& visitor, ExtendableMembersCont
     }
 }
 
-std::string allocate_temp_struct(ToCAstVisitor& visitor, ASTNode* def_node, Value* initializer) {
+TempVarName allocate_temp_struct(ToCAstVisitor& visitor, ASTNode* def_node) {
     auto struct_name = visitor.get_local_temp_var_name();
-    allocate_struct_by_name(visitor, def_node, chem::string_view(struct_name.data(), struct_name.size()));
+    allocate_struct_by_name(visitor, def_node, struct_name.view());
     return struct_name;
 }
 
@@ -1948,7 +1964,7 @@ void CDestructionVisitor::queue_destruct(std::string self_name, ASTNode* initial
     if(destructorFunc) {
         std::string drop_flag;
         if(has_drop_flag) {
-            drop_flag = visitor.get_local_temp_var_name();
+            drop_flag = visitor.get_local_temp_var_name().str();
             init_drop_flag(visitor, chem::string_view(drop_flag));
         }
         destruct_jobs.emplace_back(DestructionJob{
@@ -1982,7 +1998,7 @@ void CDestructionVisitor::queue_destruct(std::string self_name, ASTNode* initial
 
 void CDestructionVisitor::destruct_arr_ptr(const chem::string_view &self_name, Value* array_size, MembersContainer* parent_node, FunctionDeclaration* destructorFunc) {
 
-    std::string arr_val_itr_name = visitor.get_local_temp_var_name();
+    const auto arr_val_itr_name = visitor.get_local_temp_var_name();
     visitor.new_line_and_indent();
     visitor.write("for(int ");
     visitor.write(arr_val_itr_name);
@@ -1995,7 +2011,7 @@ void CDestructionVisitor::destruct_arr_ptr(const chem::string_view &self_name, V
     visitor.write(arr_val_itr_name);
     visitor.write("--){");
     visitor.indentation_level++;
-    std::string name = self_name.str() + "[" + arr_val_itr_name + "]";
+    std::string name = self_name.str() + "[" + arr_val_itr_name.str() + "]";
     destruct(chem::string_view(name.data(), name.size()), parent_node, destructorFunc, false);
     visitor.indentation_level--;
     visitor.new_line_and_indent();
@@ -2271,7 +2287,7 @@ std::string write_lambda_function(ToCAstVisitor& visitor, LambdaFunction *lamb)
     lamb_name += std::to_string(visitor.lambda_num++);
 
     // store the lambda alias
-    visitor.aliases[lamb] = lamb_name;
+    visitor.aliases[lamb] = visitor.store_name(chem::string_view(lamb_name));
 
     if(!lamb->captureList.empty()) {
         visitor.new_line_and_indent();
@@ -2282,7 +2298,7 @@ std::string write_lambda_function(ToCAstVisitor& visitor, LambdaFunction *lamb)
         visitor.write('{');
         visitor.indentation_level += 1;
         for(auto& var : lamb->captureList) {
-            visitor.aliases[var] = lamb_name + "_cap";
+            visitor.aliases[var] = visitor.store_name(chem::string_view(lamb_name + "_cap"));
             visitor.new_line_and_indent();
             visitor.visit(var->known_type());
             visitor.space();
@@ -3262,10 +3278,15 @@ void ToCAstVisitor::end_translate() {
 
 void ToCAstVisitor::file_level_reset() {
     allocator.clear();
+    names_reset();
+    destructor.file_level_reset();
+}
+
+void ToCAstVisitor::names_reset() {
     local_allocated.clear();
     destructible_refs.clear();
-    destructor.file_level_reset();
     aliases.clear();
+    names_allocator.clear();
 }
 
 void ToCAstVisitor::reset() {
@@ -3273,7 +3294,7 @@ void ToCAstVisitor::reset() {
     indentation_level = 0;
     local_temp_var_i = 0;
     nested_value = false;
-    return_redirect_block = "";
+    return_redirect_block = chem::string_view();
     destructor.reset();
 }
 
@@ -3287,13 +3308,20 @@ void ToCAstVisitor::indent() {
     }
 }
 
-std::string ToCAstVisitor::get_local_temp_var_name() {
-    std::string name;
-    name.append("__chx__lv__");
-    name.append(std::to_string(local_temp_var_i++));
+TempVarName ToCAstVisitor::get_local_temp_var_name() {
+    static constexpr std::string_view prefix = "__chx__lv__";
+    TempVarName name;
+    std::memcpy(name.buffer, prefix.data(), prefix.size());
+    const auto end = sizeof(name.buffer) / sizeof(char);
+    const auto result = std::to_chars(name.buffer + prefix.size(), name.buffer + end, local_temp_var_i++);
+    name.length = static_cast<unsigned>(result.ptr - name.buffer);
     return name;
 }
 
+chem::string_view ToCAstVisitor::store_name(const chem::string_view& name) {
+    return { names_allocator.allocate_str(name.data(), name.size()), name.size() };
+}
+
 void ToCAstVisitor::write_str_value(const chem::string_view& view) {
     write('"');
     write_encoded(*this, view);
@@ -3442,7 +3470,7 @@ void ToCAstVisitor::return_value(Value* val, BaseType* non_canon_type) {
                 write("struct ");
                 mangle(struct_def);
                 write(" ");
-                write_str(temp_name);
+                write(temp_name);
                 write(" = ");
                 visit(val);
                 write(";");
@@ -3450,7 +3478,7 @@ void ToCAstVisitor::return_value(Value* val, BaseType* non_canon_type) {
                 write('*');
                 write(get_struct_return_param_name(*this));
                 write(" = (void*)&");
-                write_str(temp_name);
+                write(temp_name);
             }
         } else {
             write('*');
@@ -3507,7 +3535,7 @@ void ToCAstVisitor::destruct_till_loop_scope_above() {
 void ToCAstVisitor::writeReturnStmtFor(Value* returnValue) {
     const auto val = returnValue;
     const auto return_type = current_func_type->returnType;
-    std::string saved_into_temp_var;
+    TempVarName saved_into_temp_var;
     const auto has_struct_like_return = return_type->isStructLikeType();
     if(val && has_struct_like_return) {
         return_value(val, return_type);
@@ -4352,7 +4380,7 @@ void contained_func_decl(ToCAstVisitor& visitor, FunctionDeclaration* decl, bool
     }
     const auto is_destructor = decl->is_delete_fn();
     const bool has_cleanup_block = is_destructor;
-    std::string cleanup_block_name;
+    chem::string_view cleanup_block_name;
     if(has_cleanup_block) {
         cleanup_block_name = "__chx__dstctr_clnup_blk__";
         visitor.return_redirect_block = cleanup_block_name;
@@ -4382,7 +4410,7 @@ void contained_func_decl(ToCAstVisitor& visitor, FunctionDeclaration* decl, bool
         visitor.indentation_level--;
         visitor.new_line_and_indent();
         visitor.write("}");
-        visitor.return_redirect_block = "";
+        visitor.return_redirect_block = chem::string_view();
     }
     visitor.indentation_level-=1;
     visitor.new_line_and_indent();
@@ -4415,7 +4443,7 @@ void do_patt_mat_expr(ToCAstVisitor& visitor, PatternMatchExpr* value) {
     }
     visitor.visit(value->expression);
     visitor.write(';');
-    visitor.local_allocated[value] = varName;
+    visitor.local_allocated[value] = visitor.store_name(varName.view());
 }
 
 void do_patt_mat_expr_cond(ToCAstVisitor& visitor, PatternMatchExpr* value) {
@@ -4707,7 +4735,7 @@ void ToCAstVisitor::VisitDeleteStmt(DestructStmt *stmt) {
     nested_value = true;
     auto self_name = get_local_temp_var_name();
     visit(stmt->identifier->getType());
-    write_str(self_name);
+    write(self_name);
     write(" = ");
     visit(stmt->identifier);
     write(';');
@@ -4725,9 +4753,9 @@ void ToCAstVisitor::VisitDeleteStmt(DestructStmt *stmt) {
         new_line_before = true;
         IntNumValue siz_val(data.array_size, comptime_scope.typeBuilder.getU64Type(), ZERO_LOC);
         if (stmt->is_array) {
-            destructor.destruct_arr_ptr(chem::string_view(self_name.data(), self_name.size()), data.array_size != 0 ? &siz_val : stmt->array_value, data.parent_node, data.destructor_func);
+            destructor.destruct_arr_ptr(self_name.view(), data.array_size != 0 ? &siz_val : stmt->array_value, data.parent_node, data.destructor_func);
         } else {
-            destructor.destruct(chem::string_view(self_name.data(), self_name.size()), data.parent_node, data.destructor_func, true);
+            destructor.destruct(self_name.view(), data.parent_node, data.destructor_func, true);
         }
         indentation_level--;
         new_line_before = true;
@@ -4791,7 +4819,7 @@ void ToCAstVisitor::VisitInValue(InValue* value) {
     new_line_and_indent();
     auto result_name = get_local_temp_var_name();
     write("bool ");
-    write_str(result_name);
+    write(result_name);
     write(';');
 
     // switch(lhs)
@@ -4812,7 +4840,7 @@ void ToCAstVisitor::VisitInValue(InValue* value) {
         // case body
         indentation_level += 1;
         new_line_and_indent();
-        write_str(result_name);
+        write(result_name);
         write(" = ");
         write(value->is_negating ? "false" : "true");
         write(';');
@@ -4826,7 +4854,7 @@ void ToCAstVisitor::VisitInValue(InValue* value) {
     write("default:");
     indentation_level += 1;
     new_line_and_indent();
-    write_str(result_name);
+    write(result_name);
     write(" = ");
     write(value->is_negating ? "true" : "false");
     write(';');
@@ -4841,7 +4869,7 @@ void ToCAstVisitor::VisitInValue(InValue* value) {
 
     // expression yields result
     new_line_and_indent();
-    write_str(result_name);
+    write(result_name);
     write(';');
 
     // close GNU statement-expression
@@ -5312,7 +5340,7 @@ bool write_destructible_call_chain_values(ToCAstVisitor& visitor, std::vector<Va
 
                 // the pointer to constructed struct
                 const auto temp_struct_ptr = visitor.get_local_temp_var_name();
-                visitor.write_str(temp_struct_ptr);
+                visitor.write(temp_struct_ptr);
                 visitor.write(" = &");
                 accept_opt_nestable(visitor, func_call, true);
                 visitor.write("; ");
@@ -5323,9 +5351,9 @@ bool write_destructible_call_chain_values(ToCAstVisitor& visitor, std::vector<Va
                 const auto last_type = values[end - 1]->getType();
                 visitor.visit(last_type);
                 visitor.write(' ');
-                visitor.write_str(temp_saved_var);
+                visitor.write(temp_saved_var);
                 visitor.write(" = ");
-                visitor.write_str(temp_struct_ptr);
+                visitor.write(temp_struct_ptr);
                 visitor.write("->");
                 access_chain(visitor, values, start + 1, end);
                 visitor.write("; ");
@@ -5334,12 +5362,12 @@ bool write_destructible_call_chain_values(ToCAstVisitor& visitor, std::vector<Va
                 visitor.mangle(destructorFn);
                 visitor.write('(');
                 if(destructorFn->has_self_param()) {
-                    visitor.write_str(temp_struct_ptr);
+                    visitor.write(temp_struct_ptr);
                 }
                 visitor.write("); ");
 
                 // returning the saved temporary variable
-                visitor.write_str(temp_saved_var);
+                visitor.write(temp_saved_var);
                 visitor.write("; })");
 
                 return true;
@@ -5460,7 +5488,7 @@ struct ArgDestructionDep {
 struct ArgsDestructionInfo {
     std::vector<ArgDestructionDep> deps;
     // when return is non-void, primitive (integer or pointer), we save it into a var
-    std::string return_save_var;
+    TempVarName return_save_var;
 };
 
 FunctionCall* get_last_call(Value* value) {
@@ -5696,9 +5724,9 @@ void write_alloc_vars_for_deps(ToCAstVisitor& visitor, ArgsDestructionInfo& info
             visitor.write('*');
         }
         visitor.space();
-        visitor.write_str(temp_var_name);
+        visitor.write(temp_var_name);
         visitor.write("; ");
-        visitor.local_allocated[dep.arg_val] = temp_var_name;
+        visitor.local_allocated[dep.arg_val] = visitor.store_name(temp_var_name.view());
     }
 }
 
@@ -5713,7 +5741,7 @@ void handle_pre_call_destruction_deps(ToCAstVisitor& visitor, ArgsDestructionInf
             visitor.visit(func_type->returnType);
             visitor.space();
             info.return_save_var = visitor.get_local_temp_var_name();
-            visitor.write_str(info.return_save_var);
+            visitor.write(info.return_save_var);
             visitor.write(" = ");
         }
     }
@@ -5729,7 +5757,7 @@ void write_destruct_vars_for_deps(ToCAstVisitor& visitor, ArgsDestructionInfo& i
         if (dep.arg_val->kind() != ValueKind::StructValue) {
             visitor.write('&');
         }
-        visitor.write_str(found->second);
+        visitor.write(found->second);
         visitor.write("); ");
     }
 }
@@ -5740,7 +5768,7 @@ void handle_post_call_destruction_deps(ToCAstVisitor& visitor, ArgsDestructionIn
         visitor.write("; ");
         write_destruct_vars_for_deps(visitor, info);
         if (!info.return_save_var.empty()) {
-            visitor.write_str(info.return_save_var);
+            visitor.write(info.return_save_var);
             visitor.write("; ");
         }
         visitor.write("})");
@@ -5772,7 +5800,7 @@ void writeStructReturningFunctionCall(ToCAstVisitor& visitor, FunctionCall* call
         visitor.write("; }))");
     } else {
         const auto temp_name_str = visitor.get_local_temp_var_name();
-        const auto temp_name = chem::string_view(temp_name_str);
+        const auto temp_name = temp_name_str.view();
         allocate_struct_by_name_no_init(visitor, return_linked, temp_name);
         visitor.write("; ");
         // write function name
@@ -5872,7 +5900,7 @@ void struct_returning_capture_call(ToCAstVisitor& visitor, FunctionCall* call, C
         // TODO we'll remove this block, and generate an error
         // allocation should have been done before
         const auto temp_name_str = visitor.get_local_temp_var_name();
-        const auto temp_name = chem::string_view(temp_name_str);
+        const auto temp_name = temp_name_str.view();
         allocate_struct_by_name_no_init(visitor, return_linked, temp_name);
         visitor.write("; ");
         write_capturing_function_call(visitor, call, capType, temp_name);
@@ -5890,12 +5918,12 @@ void write_capturing_function_call_handle_returns(ToCAstVisitor& visitor, Functi
     if (returnTypeKind == BaseTypeKind::Dynamic) {
         visitor.write("(*({ __chemical_fat_pointer__ ");
         const auto temp_name = visitor.get_local_temp_var_name();
-        visitor.write_str(temp_name);
+        visitor.write(temp_name);
         visitor.write("; ");
-        write_capturing_function_call(visitor, call, capType, chem::string_view(temp_name));
+        write_capturing_function_call(visitor, call, capType, temp_name.view());
         // write function name
         visitor.write("; &");
-        visitor.write_str(temp_name);
+        visitor.write(temp_name);
         visitor.write("; }))");
         if(!visitor.nested_value) {
             visitor.write(';');
@@ -6034,15 +6062,15 @@ void ToCAstVisitor::VisitFunctionCall(FunctionCall *call) {
         if (returnTypeKind == BaseTypeKind::Dynamic) {
             write("(*({ __chemical_fat_pointer__ ");
             const auto temp_name = get_local_temp_var_name();
-            write_str(temp_name);
+            write(temp_name);
             write("; ");
             // write function name
             visit(call->parent_val);
             write("(&");
-            write_str(temp_name);
+            write(temp_name);
             complete_func_call_args(*this, call, func_type, true);
             write("); &");
-            write_str(temp_name);
+            write(temp_name);
             write("; }))");
             if(!nested_value) {
                 write(';');
@@ -7041,7 +7069,7 @@ void ToCAstVisitor::VisitPatternMatchExpr(PatternMatchExpr* value) {
         write('}');
     }
 
-    local_allocated[value] = varName;
+    local_allocated[value] = store_name(varName.view());
 }
 
 void ToCAstVisitor::VisitMultipleValue(MultipleValue* value) {
@@ -7089,14 +7117,14 @@ void ToCAstVisitor::VisitIndexOperator(IndexOperator *op) {
                     visit(returnType);
                     space();
                     const auto saveVar = get_local_temp_var_name();
-                    write_str(saveVar);
+                    write(saveVar);
                     write(" = ");
                     write("(*");
                     call_two_arg_operator_func(*this, func, op->parent_val, op->idx);
                     write(')');
                     write("; ");
                     write_destruct_vars_for_deps(*this, info);
-                    write_str(saveVar);
+                    write(saveVar);
                     write("; })");
                 } else {
                     write("(*");
@@ -7279,7 +7307,7 @@ std::string lambda_name_from_value(ToCAstVisitor& visitor, Value* value) {
     if(found == aliases.end()) {
         return "extraction value not found";
     }
-    return found->second;
+    return found->second.str();
 }
 
 void ToCAstVisitor::VisitExtractionValue(ExtractionValue* value) {
@@ -7424,11 +7452,11 @@ void visit_wrapped_value(ToCAstVisitor& visitor, ASTNode* node, Value* value) {
             const auto temp_name = visitor.get_local_temp_var_name();
             visitor.visit(val_type);
             visitor.write(' ');
-            visitor.write_str(temp_name);
+            visitor.write(temp_name);
             visitor.write(" = ");
             visitor.visit(value);
             visitor.write(';');
-            visitor.destructor.queue_destruct(std::move(temp_name), node, destr->parent()->as_extendable_member_container(), false, false);
+            visitor.destructor.queue_destruct(temp_name.str(), node, destr->parent()->as_extendable_member_container(), false, false);
             return;
         }
     }
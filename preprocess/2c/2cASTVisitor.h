@@ -15,18 +15,57 @@
 #include "compiler/mangler/NameMangler.h"
 #include "core/source/LocationManager.h"
 #include "BufferedWriter.h"
+#include "ast/base/ASTAllocator.h"
 
 class ImplementationsIndex;
 class CoreNodes;
 class InterpretScope;
 class GlobalInterpretScope;
-class ASTAllocator;
 class CompilerBinder;
 class CDestructionVisitor;
 
 class FunctionType;
 class MembersContainer;
 
+/**
+ * name of a local temporary variable, the prefix and the counter are formatted into
+ * an inline buffer, so creating, copying and writing the name doesn't allocate
+ */
+struct TempVarName {
+
+    /**
+     * the formatted name, not null terminated
+     */
+    char buffer[24];
+
+    /**
+     * length of the name in the buffer, zero when there's no name
+     */
+    unsigned length = 0;
+
+    /**
+     * is there no name
+     */
+    inline bool empty() const noexcept {
+        return length == 0;
+    }
+
+    /**
+     * view over the name
+     */
+    inline chem::string_view view() const noexcept {
+        return { buffer, length };
+    }
+
+    /**
+     * copies the name into a string, for the few places that keep it beyond the temporary
+     */
+    inline std::string str() const {
+        return { buffer, length };
+    }
+
+};
+
 class ToCAstVisitor : public NonRecursiveVisitor<ToCAstVisitor>, public ASTDiagnoser {
 public:
 
@@ -130,18 +169,18 @@ public:
     /**
      * store the name of the current assignable
      */
-    std::string current_assignable;
+    TempVarName current_assignable;
 
     /**
-     * allocated values locally, based on Value*
+     * allocated values locally, based on Value*, names are stored in the names allocator (see store_name)
      */
-    std::unordered_map<Value*, std::string> local_allocated;
+    std::unordered_map<Value*, chem::string_view> local_allocated;
 
     /**
      * destructible_refs are references to structs / function calls that created structs inside function calls
      * and we're basically going to destruct them after the function call
      */
-    std::unordered_map<Value*, std::string> destructible_refs;
+    std::unordered_map<Value*, chem::string_view> destructible_refs;
 
     /**
      * map tells which static interfaces have implementations
@@ -178,13 +217,20 @@ public:
     /**
      * when not empty, return statement would make a goto to this block instead
      */
-    std::string return_redirect_block;
+    chem::string_view return_redirect_block;
 
     /**
      * values or nodes can be used as keys, where as strings can be used to store
      * aliased names, which later can be accessed
      */
-    std::unordered_map<void*, std::string> aliases;
+    std::unordered_map<void*, chem::string_view> aliases;
+
+    /**
+     * names stored in the side maps (local_allocated, destructible_refs, aliases) are copied into this
+     * allocator, it's owned by the visitor, because the file allocator it's given is also cleared
+     * by the processor (which doesn't know about these maps)
+     */
+    ASTAllocator names_allocator;
 
     /**
      * a single unsigned int that can be used to track emitted lambdas
@@ -237,7 +283,13 @@ public:
     /**
      * get a local variable name, that is unique
      */
-    std::string get_local_temp_var_name();
+    TempVarName get_local_temp_var_name();
+
+    /**
+     * copies the name into the names allocator, which is cleared for every file, so names stored
+     * in the side maps (local_allocated, aliases) don't need an allocation of their own
+     */
+    chem::string_view store_name(const chem::string_view& name);
 
     /**
      * emits a new line and writes line directives if needed
@@ -377,6 +429,13 @@ public:
         writer.append(str.data(), str.size());
     }
 
+    /**
+     * write the temporary variable name to stream
+     */
+    inline void write(const TempVarName& name) noexcept {
+        writer.append(name.buffer, name.length);
+    }
+
     /**
      * write the view encoded
      */
@@ -494,6 +553,13 @@ public:
      */
     void file_level_reset();
 
+    /**
+     * clears the side maps (local_allocated, destructible_refs, aliases) and the names stored for them
+     * called by file level reset, must also be called when a module is only declared (not implemented)
+     * because the maps are keyed by values and nodes of the module, which are disposed after it
+     */
+    void names_reset();
+
     /**
      * this should be called after translating a single module
      * so the visitor can be reused to translate another module
@@ -24,12 +24,11 @@ std::shared_ptr<LexResult> WorkspaceManager::get_lexed(const std::string& path,
 }
 
 bool WorkspaceManager::get_lexed(LexResult* result, const std::string& path, bool keep_comments) {
-    auto overridden_source_opt = get_overridden_source(path);
+    auto overridden_source = get_overridden_source(path, &result->source_version);
     result->abs_path = path;
-    if (overridden_source_opt.has_value()) {
-        result->overridden_source = std::move(overridden_source_opt.value());
-        auto& overridden_source = result->overridden_source;
-        InputSource input_source(overridden_source.c_str(), overridden_source.size());
+    if (overridden_source) {
+        result->overridden_source = std::move(overridden_source);
+        auto input_source = DocumentSource::input_source(result->overridden_source);
         Lexer lexer(path, input_source, &binder, result->fileAllocator);
         if(keep_comments) {
             lexer.keep_comments = true;
@@ -22,6 +22,7 @@
 #include "compiler/symres/NodeSymbolDeclarer.h"
 #include "ast/statements/ChildrenMapNode.h"
 #include <functional>
+#include <algorithm>
 #include <utility>
 #include "server/diagnostics/DiagnosticUtils.h"
 
@@ -39,7 +40,8 @@ bool parse_file(
         ASTAllocator& allocator,
         ASTUnit& unit,
         Token* start_token,
-        std::vector<Diag>* outDiags
+        std::vector<Diag>* outDiags,
+        std::vector<Token*>* ends = nullptr
 ) {
 
     auto& binder = manager.binder;
@@ -66,7 +68,11 @@ bool parse_file(
     parser.parent_node = &unit.scope;
 
     // actual parsing
-    parser.parse(unit.scope.body.nodes);
+    if(ends) {
+        parser.parse(unit.scope.body.nodes, *ends);
+    } else {
+        parser.parse(unit.scope.body.nodes);
+    }
 
     // if given we send back the diagnostics
     if(outDiags) {
@@ -255,10 +261,9 @@ void parseModuleWithDepsWait(
 
 inline static void declareAllSymbols(SymbolResolver& resolver, ChildrenMapNode* children) {
     // user didn't give any alias or symbols
-    // declare everything
-    for (auto& sym: children->symbols) {
-        resolver.declare_or_shadow(sym.first, sym.second);
-    }
+    // declare everything, the exported symbols are built into a layer once
+    // and shared by all the modules that depend on this module
+    resolver.declare_layer(children->get_layer());
 }
 
 static void declareChildren(SymbolResolver& resolver, DependencySymbolInfo* info, ChildrenMapNode* children) {
@@ -319,9 +324,24 @@ void declareDependencies(SymbolResolver& resolver, ModuleData* modData) {
     }
 }
 
-void sym_res_mod_sig(WorkspaceManager& manager, SymbolResolver& resolver, ModuleData* modData) {
+/**
+ * symbol resolves the signatures of the module, the cancelled function is checked before every file
+ * in every phase, returns false if cancelled, the module is made unresolved, because its files are
+ * left partially resolved
+ */
+template<typename Cancelled>
+bool sym_res_mod_sig(WorkspaceManager& manager, SymbolResolver& resolver, ModuleData* modData, Cancelled& cancelled) {
     const auto mod_index = resolver.module_scope_start();
 
+    const auto cancel_module = [&]() -> bool {
+        if(!cancelled()) {
+            return false;
+        }
+        resolver.module_scope_end(mod_index);
+        manager.make_module_unresolved(modData);
+        return true;
+    };
+
     // get the file units
     auto& fileUnits = modData->fileUnits;
 
@@ -349,6 +369,8 @@ void sym_res_mod_sig(WorkspaceManager& manager, SymbolResolver& resolver, Module
     // declaring symbols of all files
     for(const auto cachedUnit : fileUnits) {
 
+        if(cancel_module()) return false;
+
         auto& unit = cachedUnit->unit;
         auto path_str = unit.scope.meta.abs_path;
 
@@ -363,6 +385,8 @@ void sym_res_mod_sig(WorkspaceManager& manager, SymbolResolver& resolver, Module
     sig_results.reserve(fileUnits.size());
     for(const auto cachedUnit : fileUnits) {
 
+        if(cancel_module()) return false;
+
         auto& unit = cachedUnit->unit;
         auto path_str = unit.scope.meta.abs_path;
 
@@ -377,6 +401,8 @@ void sym_res_mod_sig(WorkspaceManager& manager, SymbolResolver& resolver, Module
     i = 0;
     for(const auto cachedUnit : fileUnits) {
 
+        if(cancel_module()) return false;
+
         auto& unit = cachedUnit->unit;
         auto path_str = unit.scope.meta.abs_path;
 
@@ -390,6 +416,8 @@ void sym_res_mod_sig(WorkspaceManager& manager, SymbolResolver& resolver, Module
     i = 0;
     for(const auto cachedUnit : fileUnits) {
 
+        if(cancel_module()) return false;
+
         auto& unit = cachedUnit->unit;
         auto path_str = unit.scope.meta.abs_path;
 
@@ -406,6 +434,8 @@ void sym_res_mod_sig(WorkspaceManager& manager, SymbolResolver& resolver, Module
     // set that all files inside this module has symbol resolved
     manager.unmake_module_dirty(modData);
 
+    return true;
+
 }
 
 bool sym_res_mod_sig_recursive(
@@ -473,12 +503,19 @@ std::vector<ModuleData*> flatten_dedupe_sorted(const std::vector<ModuleData*>& m
     return new_modules;
 }
 
-void sym_res_mod_deps_seq(
+/**
+ * symbol resolves the dependencies in order, the cancelled function is checked before every
+ * module and file, returns false if cancelled, the modules left are made unresolved, because they
+ * must take the changes in the modules that were resolved
+ */
+template<typename Cancelled>
+bool sym_res_mod_deps_seq(
         int id,
         WorkspaceManager& manager,
         SymbolResolver& resolver,
         ModuleData* modData,
-        bool& is_deps_being_symbol_resolved
+        bool& is_deps_being_symbol_resolved,
+        Cancelled& cancelled
 ) {
 
     // this prevents duplicate module entries
@@ -486,15 +523,24 @@ void sym_res_mod_deps_seq(
     auto flattened_deps = flatten_dedupe_sorted(modData->dependencies);
 
     // symbol resolve all modules that are flattened
-    for(const auto mod : flattened_deps) {
+    const auto size = flattened_deps.size();
+    for(std::size_t i = 0; i < size; i++) {
+        const auto mod = flattened_deps[i];
         if(!is_deps_being_symbol_resolved && !mod->completely_symbol_resolved()) {
             // force symbol resolution, if one of the file is not symbol resolved
             is_deps_being_symbol_resolved = true;
         }
         if(!is_deps_being_symbol_resolved) continue;
-        sym_res_mod_sig(manager, resolver, mod);
+        if(cancelled() || !sym_res_mod_sig(manager, resolver, mod, cancelled)) {
+            for(auto j = i; j < size; j++) {
+                manager.make_module_unresolved(flattened_deps[j]);
+            }
+            return false;
+        }
     }
 
+    return true;
+
 }
 
 bool sym_res_mod_sig_recursive(
@@ -507,8 +553,11 @@ bool sym_res_mod_sig_recursive(
     if(!sym_res_mod_deps_sig(id, manager, resolver, modData, is_deps_being_symbol_resolved)) {
         return false;
     }
-    // symbol resolve the signature of the module
-    sym_res_mod_sig(manager, resolver, modData);
+    // symbol resolve the signature of the module, dependencies resolved on the pool aren't cancelled
+    const auto never_cancelled = []() -> bool {
+        return false;
+    };
+    sym_res_mod_sig(manager, resolver, modData, never_cancelled);
     return true;
 }
 
@@ -626,7 +675,127 @@ void removeDeclInstantiations(InstantiationsContainer& container, Scope& scope)
     }
 }
 
-void WorkspaceManager::process_file(const std::string& abs_path, bool current_file_changed, bool depends_on_dirty) {
+/**
+ * the number of tokens after a top level node that must be unchanged for the node to be reused
+ * because the parser looks at the tokens after the node to decide where it ends
+ */
+constexpr unsigned int REUSE_LOOKAHEAD_TOKENS = 2;
+
+/**
+ * a unit is parsed from scratch after these many incremental parses, because the nodes replaced
+ * by incremental parses stay in the unit's allocator until then
+ */
+constexpr std::size_t MAX_INCREMENTAL_PARSES = 16;
+
+inline bool is_comment_token(const Token& token) {
+    return token.type == TokenType::SingleLineComment || token.type == TokenType::MultiLineComment;
+}
+
+/**
+ * generic declarations keep their instantiations inside them, which are removed when the file
+ * changes, so nodes that (may) contain them are always parsed again
+ */
+bool may_contain_generic_decls(ASTNode* node) {
+    switch(node->kind()) {
+        case ASTNodeKind::GenericFuncDecl:
+        case ASTNodeKind::GenericStructDecl:
+        case ASTNodeKind::GenericUnionDecl:
+        case ASTNodeKind::GenericInterfaceDecl:
+        case ASTNodeKind::GenericVariantDecl:
+        case ASTNodeKind::IfStmt:
+            return true;
+        case ASTNodeKind::NamespaceDecl:{
+            for(const auto child : node->as_namespace_unsafe()->nodes) {
+                if(may_contain_generic_decls(child)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        default:
+            return false;
+    }
+}
+
+/**
+ * counts the top level nodes at the start of the cached unit that can be kept after an edit, these
+ * are the nodes whose tokens (with position) are the same in the new tokens (without comments)
+ */
+std::size_t reusable_nodes_count(CachedASTUnit& cachedUnit, std::vector<Token>& tokens) {
+    auto& nodes = cachedUnit.unit.scope.body.nodes;
+    if(cachedUnit.parsed_lexes.empty() || cachedUnit.parsed_lexes.size() >= MAX_INCREMENTAL_PARSES || cachedUnit.node_ends.size() != nodes.size()) {
+        return 0;
+    }
+    // index of the first token that changed
+    std::size_t changed = 0;
+    for(auto& prev : cachedUnit.parsed_lexes.back()->tokens) {
+        if(is_comment_token(prev)) continue;
+        if(changed == tokens.size()) break;
+        auto& token = tokens[changed];
+        if(token.type != prev.type || token.value != prev.value || !token.position.is_equal(prev.position)) {
+            break;
+        }
+        changed++;
+    }
+    std::size_t count = 0;
+    while(count < nodes.size() && cachedUnit.node_ends[count] + REUSE_LOOKAHEAD_TOKENS <= changed && !may_contain_generic_decls(nodes[count])) {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * parses the tokens (without comments) of the cached unit, the first reused top level nodes of the
+ * unit are kept, their tokens are linked like the previous tokens, the rest of the nodes are parsed
+ * again from the token after the last reused node
+ */
+void parse_cached_unit(
+        WorkspaceManager& manager,
+        CachedASTUnit& cachedUnit,
+        const std::shared_ptr<LexResult>& lexResult,
+        std::vector<Token>& tokens,
+        std::size_t reused,
+        std::vector<Diag>& outDiags
+) {
+    auto& nodes = cachedUnit.unit.scope.body.nodes;
+    std::size_t start = 0;
+    if(reused == 0) {
+        nodes.clear();
+        cachedUnit.allocator.clear();
+        cachedUnit.parsed_lexes.clear();
+        cachedUnit.node_ends.clear();
+        cachedUnit.parse_diags.clear();
+    } else {
+        start = cachedUnit.node_ends[reused - 1];
+        // link the tokens of reused nodes, like the previous tokens were
+        std::size_t i = 0;
+        for(auto& prev : cachedUnit.parsed_lexes.back()->tokens) {
+            if(is_comment_token(prev)) continue;
+            if(i == start) break;
+            tokens[i].linked = prev.linked;
+            i++;
+        }
+        nodes.resize(reused);
+        cachedUnit.node_ends.resize(reused);
+        // diagnostics of the reused nodes are before the re-parsed tokens
+        const auto& position = tokens[start].position;
+        auto& diags = cachedUnit.parse_diags;
+        diags.erase(std::remove_if(diags.begin(), diags.end(), [&position](Diag& diag) {
+            return !diag.range.start.is_behind(position);
+        }), diags.end());
+    }
+    std::vector<Token*> ends;
+    std::vector<Diag> diags;
+    parse_file(manager, cachedUnit.allocator, cachedUnit.unit, tokens.data() + start, &diags, &ends);
+    for(const auto end : ends) {
+        cachedUnit.node_ends.emplace_back(static_cast<unsigned int>(end - tokens.data()));
+    }
+    cachedUnit.parse_diags.insert(cachedUnit.parse_diags.end(), diags.begin(), diags.end());
+    cachedUnit.parsed_lexes.emplace_back(lexResult);
+    outDiags = cachedUnit.parse_diags;
+}
+
+bool WorkspaceManager::process_file(const std::string& abs_path, bool current_file_changed, bool depends_on_dirty, bool background) {
 
     if (verbose) {
         std::cout << "[lsp] processing file '" << abs_path << "'" << std::endl;
@@ -640,7 +809,19 @@ void WorkspaceManager::process_file(const std::string& abs_path, bool current_fi
         if (verbose) {
             std::cout << "[lsp] process_file: couldn't get tokens, probably read error '" << abs_path << "'" << std::endl;
         }
-        return;
+        return true;
+    }
+
+    // processing is cancelled when the file has been changed again (the newer change is processed instead)
+    // or when a request is waiting for the background processing, checked only before the ast is changed
+    const auto cancelled = [this, &abs_path, &last_file, background]() -> bool {
+        return (background && waiting_requests.load() > 0) || is_stale(abs_path, last_file->source_version);
+    };
+    if(cancelled()) {
+        if (verbose) {
+            std::cout << "[lsp] process_file: cancelled '" << abs_path << "'" << std::endl;
+        }
+        return false;
     }
 
     auto abs_path_view = chem::string_view(abs_path);
@@ -662,7 +843,7 @@ void WorkspaceManager::process_file(const std::string& abs_path, bool current_fi
         if (verbose) {
             std::cout << "[lsp] process_file: skipping parsing, errors occurred during lexing '" << abs_path_view << "'" << std::endl;
         }
-        return;
+        return true;
 
     }
 
@@ -693,9 +874,6 @@ void WorkspaceManager::process_file(const std::string& abs_path, bool current_fi
     auto t = create_target_data();
     GlobalInterpretScope comptime_scope(OutputMode::Debug, t, nullptr, nullptr, resolver_allocator, typeBuilder, loc_man);
 
-    // guard from multiple requests, we only process a single file
-    std::lock_guard guard_process_file(process_file_mutex);
-
     // let's do symbol resolution
     SymbolResolver resolver(
             binder,
@@ -740,7 +918,12 @@ void WorkspaceManager::process_file(const std::string& abs_path, bool current_fi
         bool is_direct_deps_sym_res = false;
         // we ignore the flag returned from this
         // because that considers all files (we want to ignore current file)
-        sym_res_mod_deps_seq(0, *this, resolver, modData, is_direct_deps_sym_res);
+        if(!sym_res_mod_deps_seq(0, *this, resolver, modData, is_direct_deps_sym_res, cancelled) || cancelled()) {
+            if (verbose) {
+                std::cout << "[lsp] process_file: cancelled after resolving dependencies '" << abs_path << "'" << std::endl;
+            }
+            return false;
+        }
 
         if (verbose) {
             std::cout << "[lsp] process_file: is_direct_deps_sym_res " << is_direct_deps_sym_res << std::endl;
@@ -787,12 +970,25 @@ void WorkspaceManager::process_file(const std::string& abs_path, bool current_fi
             // can delete previous stuff off
             modData->allocator.clear();
 
+            // the files of the module are left partially resolved when cancelled
+            const auto cancel_module = [this, modData, &cancelled, &abs_path]() -> bool {
+                if(!cancelled()) {
+                    return false;
+                }
+                make_module_unresolved(modData);
+                if (verbose) {
+                    std::cout << "[lsp] process_file: cancelled while resolving current module '" << abs_path << "'" << std::endl;
+                }
+                return true;
+            };
+
             // a container for private symbol ranges (of files)
             std::vector<SymbolRange> priv_sym_ranges(modData->fileUnits.size());
 
             // declaring top level symbols of all files in module
             i = 0;
             for (const auto cachedUnit: modData->fileUnits) {
+                if(cancel_module()) return false;
                 auto& unit = cachedUnit->unit;
                 if (last_file->fileId != unit.scope.getFileId()) {
                     priv_sym_ranges[i] = resolver.tld_declare_file(unit.scope.body, unit.scope.meta.file_id, unit.scope.meta.abs_path);
@@ -805,6 +1001,7 @@ void WorkspaceManager::process_file(const std::string& abs_path, bool current_fi
             std::vector<SymResSignatureResult> sig_results;
             sig_results.reserve(modData->fileUnits.size());
             for (const auto cachedUnit: modData->fileUnits) {
+                if(cancel_module()) return false;
                 auto& unit = cachedUnit->unit;
                 if (last_file->fileId != unit.scope.getFileId()) {
                     sig_results.emplace_back(resolver.link_signature_file(unit.scope.body, unit.scope.meta.file_id, priv_sym_ranges[i]));
@@ -817,6 +1014,7 @@ void WorkspaceManager::process_file(const std::string& abs_path, bool current_fi
             // generic instantiation pass of all files in current module
             i = 0;
             for (const auto cachedUnit: modData->fileUnits) {
+                if(cancel_module()) return false;
                 auto& unit = cachedUnit->unit;
                 if (last_file->fileId != unit.scope.getFileId()) {
                     resolver.generic_instantiation_file(unit.scope.body, unit.scope.meta.file_id, priv_sym_ranges[i], sig_results[i]);
@@ -826,6 +1024,7 @@ void WorkspaceManager::process_file(const std::string& abs_path, bool current_fi
 
             i = 0;
             for(const auto cachedUnit : modData->fileUnits) {
+                if(cancel_module()) return false;
                 auto& unit = cachedUnit->unit;
                 if (last_file->fileId != unit.scope.getFileId()) {
                     auto& priv_sym_range = priv_sym_ranges[i];
@@ -866,7 +1065,6 @@ void WorkspaceManager::process_file(const std::string& abs_path, bool current_fi
         if(found != modData->cachedUnits.end()) {
 
             auto& cachedUnit = *found->second;
-            auto& allocator = cachedUnit.allocator;
             auto& astUnit = cachedUnit.unit;
 
             if (verbose) {
@@ -886,6 +1084,13 @@ void WorkspaceManager::process_file(const std::string& abs_path, bool current_fi
                     std::cout << "[lsp] process_file: reparsing file '" << abs_path << "' file changed or tokens didn't exist before" << std::endl;
                 }
 
+                // when only this file was edited, top level nodes before the edit are kept
+                const auto reused = current_file_changed && !depends_on_dirty ? reusable_nodes_count(cachedUnit, copied_tokens) : 0;
+
+                if (verbose) {
+                    std::cout << "[lsp] process_file: reusing " << reused << " of " << astUnit.scope.body.nodes.size() << " top level nodes '" << abs_path << "'" << std::endl;
+                }
+
                 // THE ORDER OF OPERATIONS IN THE NEXT THREE STATEMENTS IS IMPORTANT
                 // we will set this file symbol resolved = false
                 // so next time a file is opened that depends on the module that contains this file
@@ -894,15 +1099,15 @@ void WorkspaceManager::process_file(const std::string& abs_path, bool current_fi
                 // remove any instantiations we may have for this file
                 // this will also remove from inside the ast (must be done before clearing allocator)
                 instContainer.removeInstantiationsFor(astUnit.scope.meta.file_id);
-                removeDeclInstantiations(instContainer, astUnit.scope.body);
-                // clear the previous unit
-                astUnit.scope.body.nodes.clear();
-                allocator.clear();
+                auto& nodes = astUnit.scope.body.nodes;
+                for(auto n = reused; n < nodes.size(); n++) {
+                    removeNodeInstantiations(instContainer, nodes[n]);
+                }
 
-                // parse the new tokens into the ast unit
+                // parse the new tokens into the ast unit (the previous unit is cleared)
                 // we need to parse, because the parseModule above won't parse any file
                 // since module has already (probably) prepared the file units (done once)
-                parse_file(*this, allocator, astUnit, copied_tokens.data(), &parse_diagnostics);
+                parse_cached_unit(*this, cachedUnit, last_file, copied_tokens, reused, parse_diagnostics);
 
             }
 
@@ -996,6 +1201,8 @@ void WorkspaceManager::process_file(const std::string& abs_path, bool current_fi
     // publish diagnostics will return ast import unit ref
     publish_diagnostics(abs_path, std::move(diagnostics));
 
+    return true;
+
 }
 
 void WorkspaceManager::process_any_file(const std::string& path, bool contents_changed, bool depends_on_dirty) {
@@ -1009,6 +1216,15 @@ void WorkspaceManager::process_any_file(const std::string& path, bool contents_c
     }
 }
 
+void WorkspaceManager::process_changed_file(const std::string& path) {
+    if(path.ends_with("chemical.mod")) {
+        const auto guard = lock_for_request();
+        process_dot_mod_file(path);
+    } else {
+        queue_changed_file(path);
+    }
+}
+
 void WorkspaceManager::process_any_file_on_open(const std::string& path) {
     if(path.ends_with("chemical.mod")) {
         process_dot_mod_file(path);
@@ -1037,6 +1253,7 @@ void WorkspaceManager::process_any_file_on_open(const std::string& path) {
 std::vector<uint32_t> WorkspaceManager::get_semantic_tokens_full(const std::string_view& path) {
 
     auto abs_path = canonical(path);
+    const auto guard = lock_for_request();
     process_file_on_request(abs_path);
 
     // check if tokens exist in cache (parsed after changed contents request of file)
@@ -1099,6 +1316,9 @@ void WorkspaceManager::index_new_file(const std::string_view& non_canon_path) {
     std::cout << "[lsp] indexing created file '" << abs_path << "'" << std::endl;
 #endif
 
+    // modules may be processing in the background
+    const auto guard = lock_for_request();
+
     const auto mod = find_module_parent_of(modStorage.get_modules(), abs_path);
     if(mod == nullptr) {
         std::cerr << "[lsp] couldn't find the module file '" << abs_path << "' belongs to" << std::endl;
@@ -1154,6 +1374,9 @@ void WorkspaceManager::de_index_deleted_file(const std::string_view& editor_give
     // log
     std::cout << "[lsp] de indexing deleted file '" << path_sv << "'" << std::endl;
 
+    // modules may be processing in the background
+    const auto guard = lock_for_request();
+
     // get the module data
     const auto modData = getModuleData(path_view);
     if(!modData) {
@@ -1293,11 +1516,11 @@ std::vector<uint32_t> WorkspaceManager::get_semantic_tokens(LexResult& file) {
 
 #if defined DEBUG_TOKENS && DEBUG_TOKENS
     auto overridden = get_overridden_source(path);
-    if(overridden.has_value()) {
+    if(overridden) {
         // Writing the source code to a debug file
-        writeToProjectFile("debug/source.txt", overridden.value());
+        writeToProjectFile("debug/source.txt", *overridden);
         // Writing the source code as ascii to a debug file
-        writeAsciiToProjectFile("debug/ascii.txt", overridden.value());
+        writeAsciiToProjectFile("debug/ascii.txt", *overridden);
     }
     // serializing tokens to tokens json file
     JsonUtils utils;
@@ -31,6 +31,7 @@
 #include "server/analyzers/FormatterAnalyzer.h"
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 
 #define DEBUG_REPLACE false
 
@@ -234,11 +235,86 @@ void WorkspaceManager::initialize(const lsp::InitializeParams &params) {
     }
 }
 
-std::optional<std::string> WorkspaceManager::get_overridden_source(const std::string &path) {
-    if (overriddenSources.contains(path)) {
-        return overriddenSources[path];
+std::shared_ptr<const std::string> WorkspaceManager::get_overridden_source(const std::string &path, std::uint64_t* version) {
+    std::lock_guard guard(overridden_sources_mutex);
+    auto found = overriddenSources.find(path);
+    if (found != overriddenSources.end()) {
+        if(version) {
+            *version = found->second.version();
+        }
+        return found->second.snapshot();
+    } else {
+        return nullptr;
+    }
+}
+
+bool WorkspaceManager::is_stale(const std::string& path, std::uint64_t version) {
+    std::lock_guard guard(overridden_sources_mutex);
+    auto found = overriddenSources.find(path);
+    if (found != overriddenSources.end()) {
+        return found->second.version() != version;
     } else {
-        return std::nullopt;
+        return version != 0;
+    }
+}
+
+std::unique_lock<std::mutex> WorkspaceManager::lock_for_request() {
+    waiting_requests.fetch_add(1);
+    std::unique_lock lock(process_file_mutex);
+    if(waiting_requests.fetch_sub(1) == 1) {
+        requests_cv.notify_all();
+    }
+    return lock;
+}
+
+void WorkspaceManager::queue_changed_file(const std::string& path) {
+    std::lock_guard guard(changed_files_mutex);
+    if(std::find(changed_files.begin(), changed_files.end(), path) == changed_files.end()) {
+        changed_files.emplace_back(path);
+    }
+    if(!processing_changed_files) {
+        processing_changed_files = true;
+        pool.push([this](int) {
+            process_changed_files();
+        });
+    }
+}
+
+bool WorkspaceManager::take_changed_file(const std::string& path) {
+    std::lock_guard guard(changed_files_mutex);
+    auto found = std::find(changed_files.begin(), changed_files.end(), path);
+    if(found != changed_files.end()) {
+        changed_files.erase(found);
+        return true;
+    }
+    return false;
+}
+
+void WorkspaceManager::process_changed_files() {
+    std::unique_lock lock(process_file_mutex);
+    while(true) {
+        // requests are served first, they process the file they need themselves
+        requests_cv.wait(lock, [this]() {
+            return waiting_requests.load() == 0;
+        });
+        std::string path;
+        {
+            std::lock_guard guard(changed_files_mutex);
+            if(changed_files.empty()) {
+                processing_changed_files = false;
+                return;
+            }
+            path = std::move(changed_files.front());
+            changed_files.pop_front();
+        }
+        if(!process_file(path, true, false, true)) {
+            // cancelled, because a request is waiting or the file was changed again (which queued it
+            // again already), the file is processed before the other files, after the request
+            std::lock_guard guard(changed_files_mutex);
+            if(std::find(changed_files.begin(), changed_files.end(), path) == changed_files.end()) {
+                changed_files.emplace_front(std::move(path));
+            }
+        }
     }
 }
 
@@ -266,6 +342,7 @@ std::vector<lsp::FoldingRange> WorkspaceManager::get_folding_range(const std::st
     auto abs_path_view = chem::string_view(abs_path);
     const auto modData = getModuleData(abs_path_view);
     const auto mod = modData ? modData->getModule() : nullptr;
+    const auto guard = lock_for_request();
     process_file_on_request(abs_path, modData);
     const auto unit = get_cached_unit(*this, modData, abs_path);
     LexResult* lexResult = nullptr;
@@ -289,6 +366,7 @@ lsp::CompletionList WorkspaceManager::get_completion(const std::string_view& pat
     auto abs_path_view = chem::string_view(abs_path);
     const auto modData = getModuleData(abs_path_view);
     const auto mod = modData ? modData->getModule() : nullptr;
+    const auto guard = lock_for_request();
     process_file_on_request(abs_path, modData);
     const auto unit = get_cached_unit(*this, modData, abs_path);
     LexResult* lexResult = nullptr;
@@ -318,6 +396,7 @@ std::vector<lsp::InlayHint> WorkspaceManager::get_hints(const std::string_view&
     const auto abs_path = canonical(path);
     auto abs_path_view = chem::string_view(abs_path);
     const auto modData = getModuleData(abs_path_view);
+    const auto guard = lock_for_request();
     process_file_on_request(abs_path, modData);
     const auto unit = get_cached_unit(*this, modData, abs_path);
     if(unit) {
@@ -335,16 +414,17 @@ std::vector<lsp::TextEdit> WorkspaceManager::get_formatting(const std::string_vi
     auto lexResult = get_lexed(abs_path, true); // keep comments
     if(!lexResult) return {};
     
-    auto source = get_overridden_source(abs_path);
+    // the source the tokens were lexed from
+    auto source = lexResult->overridden_source;
     if(!source) {
         // load from disk if not overridden
         std::ifstream file(abs_path);
         if(!file.is_open()) return {};
-        source = std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        source = std::make_shared<const std::string>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
     }
 
     FormatterAnalyzer analyzer;
-    return analyzer.format(lexResult->tokens, source.value());
+    return analyzer.format(lexResult->tokens, *source);
 }
 
 /**
@@ -355,6 +435,7 @@ lsp::SignatureHelp WorkspaceManager::get_signature_help(const std::string_view&
     auto abs_path_view = chem::string_view(abs_path);
     const auto modData = getModuleData(abs_path_view);
     const auto mod = modData ? modData->getModule() : nullptr;
+    const auto guard = lock_for_request();
     process_file_on_request(abs_path, modData);
     const auto unit = get_cached_unit(*this, modData, abs_path);
     LexResult* lexResult = nullptr;
@@ -372,6 +453,7 @@ lsp::SignatureHelp WorkspaceManager::get_signature_help(const std::string_view&
 
 std::vector<lsp::DefinitionLink> WorkspaceManager::get_definition(const std::string_view& path, const Position &position) {
     const auto abs_path = canonical(path);
+    const auto guard = lock_for_request();
     process_file_on_request(abs_path);
     // check if tokens exist in cache (parsed after changed contents request of file)
     auto cachedTokens = tokenCache.get(abs_path);
@@ -387,6 +469,7 @@ std::vector<lsp::DocumentSymbol> WorkspaceManager::get_symbols(const std::string
     auto abs_path_view = chem::string_view(abs_path);
     const auto modData = getModuleData(abs_path_view);
     const auto mod = modData ? modData->getModule() : nullptr;
+    const auto guard = lock_for_request();
     process_file_on_request(abs_path, modData);
     const auto unit = get_cached_unit(*this, modData, abs_path);
     DocumentSymbolsAnalyzer analyzer(loc_man);
@@ -398,6 +481,7 @@ std::vector<lsp::DocumentSymbol> WorkspaceManager::get_symbols(const std::string
 
 std::string WorkspaceManager::get_hover(const std::string_view& path, const Position& position) {
     const auto abs_path = canonical(path);
+    const auto guard = lock_for_request();
     process_file_on_request(abs_path);
     // check if tokens exist in cache (parsed after changed contents request of file)
     auto cachedTokens = tokenCache.get(abs_path);
@@ -410,62 +494,10 @@ std::string WorkspaceManager::get_hover(const std::string_view& path, const Posi
 
 void WorkspaceManager::OnOpenedFile(const std::string_view& filePath) {
     auto abs_path = canonical_path(filePath);
+    const auto guard = lock_for_request();
     process_any_file_on_open(abs_path);
 }
 
-static size_t positionToOffset(
-        const std::string& source,
-        unsigned int targetLine,
-        unsigned int targetChar
-) {
-    size_t offset = 0;
-    unsigned int line = 0;
-    unsigned int ch = 0;
-
-    while (offset < source.size()) {
-        if (line == targetLine && ch == targetChar) {
-            return offset;
-        }
-
-        char c = source[offset++];
-
-        if (c == '\n') {
-            line++;
-            ch = 0;
-        } else if (c == '\r') {
-            // handle CRLF properly (treat as single newline)
-            if (offset < source.size() && source[offset] == '\n') {
-                offset++;
-            }
-            line++;
-            ch = 0;
-        } else {
-            ch++;
-        }
-    }
-
-    // If position is at EOF (valid in LSP)
-    return offset;
-}
-
-static void applyChange(
-        std::string& source,
-        unsigned int lineStart,
-        unsigned int charStart,
-        unsigned int lineEnd,
-        unsigned int charEnd,
-        const std::string& replacement
-) {
-    size_t startOffset = positionToOffset(source, lineStart, charStart);
-    size_t endOffset   = positionToOffset(source, lineEnd, charEnd);
-
-    if (startOffset > endOffset) {
-        std::swap(startOffset, endOffset);
-    }
-
-    source.replace(startOffset, endOffset - startOffset, replacement);
-}
-
 constexpr bool debug_replace = false;
 
 void WorkspaceManager::onChangedContents(
@@ -485,38 +517,48 @@ void WorkspaceManager::onChangedContents(
     // causing requests to this method be processed sequentially
     std::lock_guard<std::mutex> lock(incremental_change_mutex);
 
-    std::string source;
+    if(changes.size() == 1) {
+        auto changePtr = get_if<lsp::TextDocumentContentChangeEvent_Text>(&changes[0]);
+        if(changePtr) {
+            auto& change = *changePtr;
+            {
+                std::lock_guard guard(overridden_sources_mutex);
+                auto found = overriddenSources.find(path);
+                if(found != overriddenSources.end()) {
+                    found->second.assign(change.text);
+                } else {
+                    overriddenSources.emplace(path, DocumentSource(change.text));
+                }
+            }
+            // reprocess the file (re-parse and symbol resolve, reporting diagnostics)
+            process_changed_file(path);
+            return;
+        }
+    }
+
+    std::unique_lock sources_lock(overridden_sources_mutex);
 
     // load the file if it doesn't exist
-    if (!overriddenSources.contains(path)) {
+    auto found = overriddenSources.find(path);
+    if (found == overriddenSources.end()) {
         std::ifstream file;
         file.open(path);
         if (!file.is_open()) {
             std::cerr << "Unknown error opening the file" << '\n';
             return;
         }
-        source.assign(
-            std::istreambuf_iterator<char>(file),
+        std::string loaded(
+            (std::istreambuf_iterator<char>(file)),
             std::istreambuf_iterator<char>()
         );
         file.close();
-    } else {
-        source = overriddenSources[path];
+        found = overriddenSources.emplace(path, DocumentSource(std::move(loaded))).first;
     }
 
-    if(changes.size() == 1) {
-        auto changePtr = get_if<lsp::TextDocumentContentChangeEvent_Text>(&changes[0]);
-        if(changePtr) {
-            auto& change = *changePtr;
-            overriddenSources[path] = change.text;
-            // reprocess the file (re-parse and symbol resolve, reporting diagnostics)
-            process_any_file(path, true, false);
-            return;
-        }
-    }
+    auto& source = found->second;
 
 #if defined DEBUG_REPLACE && DEBUG_REPLACE
-    std::cout << "loaded the source : " << source << std::endl;
+    std::cout << "loaded the source : " << *source.snapshot() << std::endl;
     std::cout << "total changes :" << changes.size() << std::endl;
     if(changes.size() == 1) {
         auto change = changes[0];
@@ -535,8 +577,7 @@ void WorkspaceManager::onChangedContents(
         if (changePtr) {
             auto& change = *changePtr;
 
-            applyChange(
-                source,
+            source.replace(
                 change.range.start.line,
                 change.range.start.character,
                 change.range.end.line,
@@ -551,14 +592,14 @@ void WorkspaceManager::onChangedContents(
     }
 
     if (debug_replace && verbose) {
-        std::cout << "[lsp] overridden_source : " << source << std::endl;
+        std::cout << "[lsp] overridden_source : " << *source.snapshot() << std::endl;
     }
 
-    // store the overridden sources
-    overriddenSources[path] = std::move(source);
+    // the file is processed without holding the lock, lexing takes a snapshot of the source
+    sources_lock.unlock();
 
     // reprocess the file (re-parse and symbol resolve, reporting diagnostics)
-    process_any_file(path, true, false);
+    process_changed_file(path);
 
 }
 
@@ -566,6 +607,8 @@ void WorkspaceManager::onSave(const std::string_view& uri) {
     if(project_path.empty()) return;
     try {
         if (uri.ends_with("chemical.mod") || uri.ends_with(".lab")) {
+            // files may be processing in the background
+            const auto guard = lock_for_request();
             // lets try to clear everything we have on modules
             modStorage.clear();
             moduleData.clear();
@@ -586,10 +629,12 @@ void WorkspaceManager::onSave(const std::string_view& uri) {
 }
 
 void WorkspaceManager::onClosedFile(const std::string &path) {
+    std::lock_guard guard(overridden_sources_mutex);
     overriddenSources.erase(path);
 }
 
 void WorkspaceManager::clearAllStoredContents() {
+    std::lock_guard guard(overridden_sources_mutex);
     overriddenSources.clear();
 }
 
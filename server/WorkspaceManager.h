@@ -11,6 +11,9 @@
 #include <mutex>
 #include <unordered_map>
 #include <unordered_set>
+#include <deque>
+#include <atomic>
+#include <condition_variable>
 #include "utils/lspfwd.h"
 #include "utils/LRUCache.h"
 #include <future>
@@ -26,9 +29,10 @@
 #include "compiler/lab/ModuleStorage.h"
 #include "lsp/types.h"
 #include "compiler/lab/LabBuildContext.h"
-#include "ctpl.h"
+#include "utils/WorkStealingPool.h"
 #include "build/ContextSerialization.h"
 #include "server/model/ModuleData.h"
+#include "server/model/DocumentSource.h"
 #include "core/source/LocationManager.h"
 #include "compiler/processor/ModuleFileData.h"
 #include "compiler/generics/InstantiationsContainer.h"
@@ -81,7 +85,13 @@ public:
      * overridden sources contain user edited files
      * when user edits, they aren't saved directly to disk, so we store edited state here
      */
-    std::unordered_map<std::string, std::string> overriddenSources;
+    std::unordered_map<std::string, DocumentSource> overriddenSources;
+
+    /**
+     * overridden sources are changed by the change requests and read (snapshot) by the
+     * threads that lex the files, this mutex guards the map and the documents in it
+     */
+    std::mutex overridden_sources_mutex;
 
     /**
      * This mutex is for the change of files
@@ -105,10 +115,38 @@ public:
 
     /**
      * we run only a single process file operation, which resolves all dependency modules
-     * to make the requested file available and completely symbol resolved
+     * to make the requested file available and completely symbol resolved, process_file
+     * expects the caller to hold it, requests hold it until they are done reading the ast
      */
     std::mutex process_file_mutex;
 
+    /**
+     * number of requests waiting to lock the process file mutex, background processing of
+     * changed files yields to them at the next checkpoint
+     */
+    std::atomic<int> waiting_requests = 0;
+
+    /**
+     * notified (with process file mutex) when no request is waiting anymore
+     */
+    std::condition_variable requests_cv;
+
+    /**
+     * files whose contents changed and are waiting to be processed in the background, a file
+     * is queued once, edits made before it's processed are coalesced into a single processing
+     */
+    std::deque<std::string> changed_files;
+
+    /**
+     * guards the changed files queue and the processing flag below
+     */
+    std::mutex changed_files_mutex;
+
+    /**
+     * is a task draining the changed files queue on the pool
+     */
+    bool processing_changed_files = false;
+
     /**
      * why ? because semantic tokens request requires access to tokens inside which
      * linked pointers to ast nodes/values/types exist
@@ -235,7 +273,7 @@ public:
     /**
      * the thread pool is used to launch jobs
      */
-    ctpl::thread_pool pool;
+    WorkStealingPool pool;
 
     /**
      * we have a pointer to the main job
@@ -360,6 +398,42 @@ public:
         dirtyModules.erase(modData);
     }
 
+    /**
+     * the module must be symbol resolved completely again, because its symbol resolution
+     * was cancelled before it could take the changes in its dependencies or before all
+     * of its files were resolved
+     */
+    void make_module_unresolved(ModuleData* modData) {
+        modData->make_all_files_dirty();
+        dirtyModules.insert(modData);
+    }
+
+    /**
+     * locks the process file mutex for a request, a background processing of a changed
+     * file yields to it, the lock must be held until the request is done reading the ast
+     */
+    std::unique_lock<std::mutex> lock_for_request();
+
+    /**
+     * is the given version of the file older than the current contents in the editor
+     */
+    bool is_stale(const std::string& path, std::uint64_t version);
+
+    /**
+     * queue the changed file to be processed in the background
+     */
+    void queue_changed_file(const std::string& path);
+
+    /**
+     * removes the file from the changed files queue, returns true if it was queued
+     */
+    bool take_changed_file(const std::string& path);
+
+    /**
+     * processes the changed files queue, runs on the pool until the queue is empty
+     */
+    void process_changed_files();
+
     /**
      * before request, a file can be prepared, in this case
      * if this file is dirty, or a file it depends upon is dirty (not symbol resolved)
@@ -368,9 +442,11 @@ public:
     bool should_process_file(const std::string& path, ModuleData* modData);
 
     /**
-     * this allows processing the file to place unit
+     * this allows processing the file to place unit, the caller must hold the process file mutex
+     * returns false when processing was cancelled, because the file was changed again or
+     * when processing in background and a request is waiting
      */
-    void process_file(const std::string& path, bool contents_changed, bool depends_on_dirty);
+    bool process_file(const std::string& path, bool contents_changed, bool depends_on_dirty, bool background = false);
 
     /**
      * process a dot mod file
@@ -382,28 +458,34 @@ public:
      */
     void process_any_file(const std::string& path, bool contents_changed, bool depends_on_dirty);
 
+    /**
+     * processes the file after its contents changed, source files are queued to be processed
+     * in the background, so a burst of edits doesn't process every single one of them
+     */
+    void process_changed_file(const std::string& path);
+
     /**
      * process file on open (contents haven't changed, if tokens & ast exist in cache, can be skipped)
      */
     void process_any_file_on_open(const std::string& path);
 
     /**
-     * process the file only if it need by
+     * process the file only if it need by, the lock for request must be held
      */
     inline void process_file_on_request(const std::string& path, ModuleData* modData) {
-        if(modData && should_process_file(path, modData)) {
+        if(take_changed_file(path)) {
+            // changed file hasn't been processed yet, processing it now
+            process_file(path, true, false);
+        } else if(modData && should_process_file(path, modData)) {
             process_file(path, false, true);
         }
     }
 
     /**
-     * process the file only if it need by
+     * process the file only if it need by, the lock for request must be held
      */
     inline void process_file_on_request(const std::string& path) {
-        const auto modData = getModuleData(chem::string_view(path));
-        if(modData && should_process_file(path, modData)) {
-            process_file(path, false, true);
-        }
+        process_file_on_request(path, getModuleData(chem::string_view(path)));
     }
 
     /**
@@ -548,9 +630,10 @@ public:
     );
 
     /**
-     * Returns the overridden source code for file at path
+     * Returns the overridden source code for file at path, nullptr if it isn't overridden
+     * the returned source doesn't change, when the file is changed again, its version is set in the given pointer
      */
-    std::optional<std::string> get_overridden_source(const std::string& path);
+    std::shared_ptr<const std::string> get_overridden_source(const std::string& path, std::uint64_t* version = nullptr);
 
     /**
      * should be called when a file is opened
@@ -0,0 +1,111 @@
+// Copyright (c) Chemical Language Foundation 2025.
+
+#include "DocumentSource.h"
+#include <algorithm>
+
+DocumentSource::DocumentSource(std::string text) {
+    assign(std::move(text));
+}
+
+void DocumentSource::assign(std::string new_text) {
+    current_version++;
+    text = std::make_shared<std::string>(std::move(new_text));
+    line_starts.clear();
+    line_starts.emplace_back(0);
+    index_lines(1, text->size() + 1, line_starts);
+}
+
+bool DocumentSource::is_line_start(std::size_t offset) const {
+    auto& str = *text;
+    const auto prev = str[offset - 1];
+    // CRLF is a single new line, which starts after the LF
+    return prev == '\n' || (prev == '\r' && (offset >= str.size() || str[offset] != '\n'));
+}
+
+void DocumentSource::index_lines(std::size_t from, std::size_t to, std::vector<std::size_t>& out) const {
+    for(auto offset = std::max<std::size_t>(from, 1); offset < to; offset++) {
+        if(is_line_start(offset)) {
+            out.emplace_back(offset);
+        }
+    }
+}
+
+std::size_t DocumentSource::offset(unsigned int line, unsigned int character) const {
+    auto& str = *text;
+    if(line >= line_starts.size()) {
+        return str.size();
+    }
+    auto offset = line_starts[line];
+    unsigned int units = 0;
+    while(units < character && offset < str.size()) {
+        const auto c = static_cast<unsigned char>(str[offset]);
+        if(c == '\n' || c == '\r') {
+            break;
+        }
+        // length of the utf-8 sequence, code points outside the BMP are two utf-16 units
+        if(c < 0x80) {
+            offset += 1;
+            units += 1;
+        } else if((c >> 5) == 0x6) {
+            offset += 2;
+            units += 1;
+        } else if((c >> 4) == 0xE) {
+            offset += 3;
+            units += 1;
+        } else if((c >> 3) == 0x1E) {
+            offset += 4;
+            units += 2;
+        } else {
+            // invalid byte, counted as a single unit
+            offset += 1;
+            units += 1;
+        }
+    }
+    return std::min(offset, str.size());
+}
+
+void DocumentSource::replace(
+    unsigned int lineStart,
+    unsigned int charStart,
+    unsigned int lineEnd,
+    unsigned int charEnd,
+    const std::string& replacement
+) {
+    current_version++;
+    auto start = offset(lineStart, charStart);
+    auto end = offset(lineEnd, charEnd);
+    if(start > end) {
+        std::swap(start, end);
+    }
+
+    // splice the text, copying it only if a snapshot of it is held
+    if(text.use_count() > 1) {
+        auto& prev = *text;
+        auto next = std::make_shared<std::string>();
+        next->reserve(prev.size() - (end - start) + replacement.size());
+        next->append(prev, 0, start);
+        next->append(replacement);
+        next->append(prev, end, std::string::npos);
+        text = std::move(next);
+    } else {
+        text->replace(start, end - start, replacement);
+    }
+
+    // a line start depends on the two characters before it and the one at it, so the lines
+    // starting before the range and two characters after it are kept, the ones after are shifted
+    const auto kept_end = end + 2;
+    const auto first_changed = std::lower_bound(line_starts.begin(), line_starts.end(), std::max<std::size_t>(start, 1));
+    const auto first_after = std::lower_bound(first_changed, line_starts.end(), kept_end);
+    const auto new_kept_end = kept_end - (end - start) + replacement.size();
+
+    std::vector<std::size_t> changed;
+    index_lines(start, std::min(new_kept_end, text->size() + 1), changed);
+
+    std::vector<std::size_t> after(first_after, line_starts.end());
+    for(auto& line_start : after) {
+        line_start = line_start - (end - start) + replacement.size();
+    }
+    line_starts.erase(first_changed, line_starts.end());
+    line_starts.insert(line_starts.end(), changed.begin(), changed.end());
+    line_starts.insert(line_starts.end(), after.begin(), after.end());
+}
@@ -0,0 +1,108 @@
+// Copyright (c) Chemical Language Foundation 2025.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include "stream/InputSource.h"
+
+/**
+ * source of a document edited in the ide (not saved to disk), the lsp applies the changes
+ * sent by the ide to it
+ *
+ * starts of lines are indexed, so a position (line, character) is translated to an offset
+ * without walking the text before it, the index is updated only around the changed range
+ * characters are counted in utf-16 code units (the default position encoding of lsp)
+ *
+ * the text is shared with the lex results (tokens point into it), so lexing doesn't copy it,
+ * when the text is shared, a change copies it once (while splicing), otherwise it's changed in place
+ */
+class DocumentSource {
+public:
+
+    /**
+     * constructor
+     */
+    explicit DocumentSource(std::string text);
+
+    /**
+     * replace the whole text
+     */
+    void assign(std::string text);
+
+    /**
+     * get offset in the text of the given position, character is in utf-16 code units
+     * positions past the end of line or file are clamped to it
+     */
+    std::size_t offset(unsigned int line, unsigned int character) const;
+
+    /**
+     * replace the text in given range with the replacement
+     */
+    void replace(
+        unsigned int lineStart,
+        unsigned int charStart,
+        unsigned int lineEnd,
+        unsigned int charEnd,
+        const std::string& replacement
+    );
+
+    /**
+     * the current text, it doesn't change when the document is changed
+     */
+    inline std::shared_ptr<const std::string> snapshot() const {
+        return text;
+    }
+
+    /**
+     * an input source over the current text, valid while the snapshot is held
+     */
+    static inline InputSource input_source(const std::shared_ptr<const std::string>& snapshot) {
+        return { snapshot->data(), snapshot->size() };
+    }
+
+    /**
+     * the number of lines in the document
+     */
+    inline std::size_t lines_count() const noexcept {
+        return line_starts.size();
+    }
+
+    /**
+     * the version of the document, incremented on every change
+     */
+    inline std::uint64_t version() const noexcept {
+        return current_version;
+    }
+
+private:
+
+    /**
+     * the text, shared with the snapshots taken
+     */
+    std::shared_ptr<std::string> text;
+
+    /**
+     * offset of the start of every line, the first one is always zero
+     */
+    std::vector<std::size_t> line_starts;
+
+    /**
+     * the version of the document
+     */
+    std::uint64_t current_version = 0;
+
+    /**
+     * is a line started at the given offset
+     */
+    bool is_line_start(std::size_t offset) const;
+
+    /**
+     * appends the starts of lines in given range of offsets to the given vector
+     */
+    void index_lines(std::size_t from, std::size_t to, std::vector<std::size_t>& out) const;
+
+};
@@ -6,6 +6,7 @@
 #include "lexer/Token.h"
 #include "ast/base/BatchAllocator.h"
 #include <memory>
+#include <cstdint>
 
 #include "stream/FileInputSource.h"
 
@@ -48,11 +49,16 @@ struct LexResult {
 
     /**
      * when lex source is overridden source
-     * IDE has edited changes, that haven't been saved to disk, we store the source
-     * in this variable, then we lex this source, it has to be valid, because tokens above contain
-     * pointers into this string, IT must not change once initialized
+     * IDE has edited changes, that haven't been saved to disk, we hold a snapshot of the
+     * source in this variable, then we lex this source, it has to be valid, because tokens above
+     * contain pointers into this string, snapshots don't change once taken
      */
-    std::string overridden_source;
+    std::shared_ptr<const std::string> overridden_source;
+
+    /**
+     * version of the overridden source that was lexed, zero when the file was read from disk
+     */
+    std::uint64_t source_version = 0;
 
     /**
      * constructor
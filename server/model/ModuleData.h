@@ -30,6 +30,23 @@ public:
      */
     ASTUnit unit;
 
+    /**
+     * the lex results the top level nodes of the unit were parsed from, the last one is the latest
+     * the earlier ones are kept alive for nodes that were reused by incremental parses, empty when
+     * the unit wasn't parsed by process_file
+     */
+    std::vector<std::shared_ptr<LexResult>> parsed_lexes;
+
+    /**
+     * for every top level node of the unit, index of the (non comment) token after it
+     */
+    std::vector<unsigned int> node_ends;
+
+    /**
+     * diagnostics produced when parsing the top level nodes of the unit
+     */
+    std::vector<Diag> parse_diags;
+
     /**
      * cached ast units of files
      */
@@ -149,4 +166,13 @@ public:
         dirtyFiles.insert(failedUnit);
     }
 
+    /**
+     * this sets that module is not symbol resolved, and none of the files
+     * inside this module are symbol resolved
+     */
+    void make_all_files_dirty() {
+        symbol_resolved_once = false;
+        dirtyFiles.insert(fileUnits.begin(), fileUnits.end());
+    }
+
 };
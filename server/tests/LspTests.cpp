@@ -10,9 +10,27 @@
 #include "compiler/cbi/model/CompilerBinder.h"
 #include "core/diag/Diagnoser.h"
 #include "server/analyzers/FormatterAnalyzer.h"
+#include "server/WorkspaceManager.h"
+#include "server/model/ModuleData.h"
+#include <lsp/connection.h>
+#include <lsp/io/standardio.h>
+#include <lsp/messagehandler.h>
+#include <chrono>
 
 #ifdef DEBUG
 
+// defined in LspSemanticTokens.cpp
+std::size_t reusable_nodes_count(CachedASTUnit& cachedUnit, std::vector<Token>& tokens);
+
+void parse_cached_unit(
+        WorkspaceManager& manager,
+        CachedASTUnit& cachedUnit,
+        const std::shared_ptr<LexResult>& lexResult,
+        std::vector<Token>& tokens,
+        std::size_t reused,
+        std::vector<Diag>& outDiags
+);
+
 namespace {
 
 struct TestResult {
@@ -195,6 +213,109 @@ void test_vertical_spacing() {
     assert_equal("Vertical Spacing Decoration", expected, format_code(input));
 }
 
+std::shared_ptr<LexResult> lex_document(WorkspaceManager& manager, const std::string& path, std::string text) {
+    auto result = std::make_shared<LexResult>(manager.loc_man.encodeFile(path));
+    result->abs_path = path;
+    result->overridden_source = std::make_shared<const std::string>(std::move(text));
+    auto input_source = DocumentSource::input_source(result->overridden_source);
+    Lexer lexer(path, input_source, &manager.binder, result->fileAllocator);
+    lexer.keep_comments = true;
+    lexer.getTokens(result->tokens);
+    result->has_errors = lexer.diagnoser.has_errors();
+    return result;
+}
+
+// the tokens given to the parser, like process_file does, comments are removed
+std::vector<Token> parser_tokens(LexResult& lexResult) {
+    std::vector<Token> tokens;
+    tokens.reserve(lexResult.tokens.size());
+    for(auto& token : lexResult.tokens) {
+        if(token.type != TokenType::SingleLineComment && token.type != TokenType::MultiLineComment) {
+            tokens.emplace_back(token);
+        }
+    }
+    return tokens;
+}
+
+std::string incremental_document(unsigned int count, unsigned int edited) {
+    std::string text;
+    for(unsigned int i = 0; i < count; i++) {
+        const auto num = std::to_string(i);
+        text += "// function number " + num + "\n";
+        if(i == edited) {
+            text += "func f" + num + "(a : int) : int { return a * " + num + " + 1; }\n";
+        } else {
+            text += "func f" + num + "(a : int) : int { return a + " + num + "; }\n";
+        }
+        text += "struct S" + num + " { var x : int }\n";
+    }
+    return text;
+}
+
+std::string units_representation(CachedASTUnit& unit) {
+    std::string rep;
+    for(const auto node : unit.unit.scope.body.nodes) {
+        rep += node->representation();
+        rep += '\n';
+    }
+    return rep;
+}
+
+void test_incremental_parse_reuse() {
+
+    lsp::Connection connection(lsp::io::standardIO());
+    lsp::MessageHandler handler(connection);
+    WorkspaceManager manager("", handler);
+
+    const unsigned int count = 2000;
+    const unsigned int edited = 1500;
+    const std::string path = "incremental.ch";
+    ModuleScope modScope("", "test", nullptr);
+
+    // parse the document before the edit
+    CachedASTUnit cachedUnit(10000, manager.loc_man.encodeFile(path), &modScope, path);
+    auto before = lex_document(manager, path, incremental_document(count, count));
+    auto before_tokens = parser_tokens(*before);
+    std::vector<Diag> diags;
+    parse_cached_unit(manager, cachedUnit, before, before_tokens, 0, diags);
+    const std::vector<ASTNode*> before_nodes = cachedUnit.unit.scope.body.nodes;
+
+    // edit a function near the end, nodes before it should be reused
+    auto after = lex_document(manager, path, incremental_document(count, edited));
+    auto after_tokens = parser_tokens(*after);
+    const auto reused = reusable_nodes_count(cachedUnit, after_tokens);
+    assert_equal("Incremental Parse Reused Count", std::to_string(edited * 2), std::to_string(reused));
+
+    auto incremental_start = std::chrono::steady_clock::now();
+    parse_cached_unit(manager, cachedUnit, after, after_tokens, reused, diags);
+    auto incremental_time = std::chrono::steady_clock::now() - incremental_start;
+
+    auto& nodes = cachedUnit.unit.scope.body.nodes;
+    bool same_nodes = nodes.size() >= reused;
+    for(std::size_t i = 0; same_nodes && i < reused; i++) {
+        same_nodes = nodes[i] == before_nodes[i];
+    }
+    assert_equal("Incremental Parse Keeps Unchanged Nodes", "true", same_nodes ? "true" : "false");
+
+    // the result must be the same as parsing the edited document from scratch
+    CachedASTUnit fullUnit(10000, manager.loc_man.encodeFile(path), &modScope, path);
+    auto full = lex_document(manager, path, incremental_document(count, edited));
+    auto full_tokens = parser_tokens(*full);
+    std::vector<Diag> full_diags;
+    auto full_start = std::chrono::steady_clock::now();
+    parse_cached_unit(manager, fullUnit, full, full_tokens, 0, full_diags);
+    auto full_time = std::chrono::steady_clock::now() - full_start;
+
+    assert_equal("Incremental Parse Node Count", std::to_string(fullUnit.unit.scope.body.nodes.size()), std::to_string(nodes.size()));
+    assert_equal("Incremental Parse Node Ends", "true", fullUnit.node_ends == cachedUnit.node_ends ? "true" : "false");
+    assert_equal("Incremental Parse Diagnostics", std::to_string(full_diags.size()), std::to_string(diags.size()));
+    assert_equal("Incremental Parse Equals Full Parse", units_representation(fullUnit), units_representation(cachedUnit));
+
+    using micros = std::chrono::microseconds;
+    std::cout << "  incremental parse: " << std::chrono::duration_cast<micros>(incremental_time).count() << "us, full parse: " << std::chrono::duration_cast<micros>(full_time).count() << "us" << std::endl;
+
+}
+
 } // namespace
 
 
@@ -215,6 +336,12 @@ void run_lsp_tests() {
     test_vertical_spacing();
     
     std::cout << "--- Formatter Tests Complete ---" << std::endl;
+
+    std::cout << "--- Running Incremental Parse Tests ---" << std::endl;
+
+    test_incremental_parse_reuse();
+
+    std::cout << "--- Incremental Parse Tests Complete ---" << std::endl;
 }
 
 #endif
@@ -0,0 +1,50 @@
+// Copyright (c) Chemical Language Foundation 2025.
+
+#include "SourceProvider.h"
+#include <bit>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOURCE_PROVIDER_SSE2_SCAN
+#endif
+
+namespace {
+
+    inline void check_line_end(const char* data, std::size_t size, std::size_t i, std::vector<unsigned int>& out) {
+        const auto c = data[i];
+        // if there's no \n next to \r, the line ending must be CR, so we treat it as line ending
+        if (c == '\n' || c == '\x0C' || (c == '\r' && (i + 1 == size || data[i + 1] != '\n'))) {
+            out.emplace_back(static_cast<unsigned int>(i + 1));
+        }
+    }
+
+}
+
+void SourceProvider::computeLineStarts(const char* data, std::size_t size, std::vector<unsigned int>& out) {
+    out.clear();
+    // rough estimate of lines, to avoid growing the vector repeatedly
+    out.reserve(size / 32 + 1);
+    out.emplace_back(0);
+    std::size_t i = 0;
+#ifdef SOURCE_PROVIDER_SSE2_SCAN
+    const auto new_line = _mm_set1_epi8('\n');
+    const auto carriage_return = _mm_set1_epi8('\r');
+    const auto form_feed = _mm_set1_epi8('\x0C');
+    for(; i + 16 <= size; i += 16) {
+        const auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const auto matches = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(x, new_line), _mm_cmpeq_epi8(x, carriage_return)),
+                _mm_cmpeq_epi8(x, form_feed)
+        );
+        auto mask = static_cast<unsigned int>(_mm_movemask_epi8(matches));
+        while(mask != 0) {
+            check_line_end(data, size, i + std::countr_zero(mask), out);
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for(; i < size; i++) {
+        check_line_end(data, size, i, out);
+    }
+}
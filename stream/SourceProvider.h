@@ -12,8 +12,14 @@
 #include "std/chem_string.h"
 #include <istream>
 #include <streambuf>
+#include <vector>
+#include <algorithm>
 #include "InputSource.h"
 
+/**
+ * the field layout is mirrored by the SourceProvider struct in lang/libs/compiler/src/SourceProvider.ch
+ * update it when fields are added, removed or reordered
+ */
 class SourceProvider {
 private:
 
@@ -33,44 +39,69 @@ private:
     const char* const end_;
 
     /**
-     * this counts lines, zero-based
-     * On every character read, the provider checks if the line has ended and increments
+     * byte offsets at which every line starts, computed in a single pass when the provider
+     * is created, reading characters only moves the data pointer, line and character numbers
+     * are derived from it when a position is requested
      */
-    unsigned int lineNumber = 0;
+    std::vector<unsigned int> lineStarts;
 
     /**
-     * the current pos (character) to read, relative to the current line (line)
-     * zero-based
+     * the line that contains the data pointer at the time of the last position request,
+     * positions mostly move forward, so next line is found by walking from here
      */
-    unsigned int lineCharacterNumber = 0;
+    mutable unsigned int cachedLine = 0;
 
-public:
+    /**
+     * the data pointer at the time of the last position request
+     */
+    mutable const char* cachedData;
 
     /**
-     * handles the character read from the stream, when you read a character
-     * you can supply it to this function
+     * character number (zero-based) of the cached data pointer in the cached line
      */
-    inline void handleCharacterRead(char c) noexcept {
-        if (c == '\n' || c == '\x0C' || (c == '\r' && peekByte() != '\n')) {
-            // if there's no \n next to \r, the line ending must be CR, so we treat it as line ending
-            lineNumber++;
-            lineCharacterNumber = 0;
-        } else {
-            lineCharacterNumber++;
+    mutable unsigned int cachedCharacter = 0;
+
+    /**
+     * computes the byte offsets at which lines start, a line ends at \n, \f or at a \r
+     * which isn't followed by \n
+     */
+    static void computeLineStarts(const char* data, std::size_t size, std::vector<unsigned int>& out);
+
+    /**
+     * counts the characters (utf8 code points) in the given range, continuation bytes aren't counted
+     */
+    static inline unsigned int countCharacters(const char* from, const char* to) noexcept {
+        unsigned int count = 0;
+        for(; from != to; from++) {
+            count += (static_cast<unsigned char>(*from) & 0xC0u) != 0x80u;
         }
+        return count;
     }
 
     /**
-     * handles the codepoint read from the stream, when you read a code point
-     * you should use this function to handle read code point
+     * brings the cached line and character up to date with the data pointer
      */
-    inline void handleCodepointRead(char32_t cp) noexcept {
-        if (cp == U'\n' || cp == U'\f' || (cp == U'\r' && peekByte() != '\n')) {
-            lineNumber++;
-            lineCharacterNumber = 0;
+    void syncPosition() const noexcept {
+        if(data_ == cachedData) return;
+        const auto start = end_ - size_;
+        const auto offset = static_cast<unsigned int>(data_ - start);
+        auto line = cachedLine;
+        if(offset < lineStarts[line]) {
+            // position was restored backwards
+            line = static_cast<unsigned int>(std::upper_bound(lineStarts.begin(), lineStarts.begin() + line, offset) - lineStarts.begin()) - 1;
         } else {
-            lineCharacterNumber++;
+            const auto total = lineStarts.size();
+            while(line + 1 < total && lineStarts[line + 1] <= offset) {
+                line++;
+            }
         }
+        if(line == cachedLine && cachedData < data_) {
+            cachedCharacter += countCharacters(cachedData, data_);
+        } else {
+            cachedCharacter = countCharacters(start + lineStarts[line], data_);
+        }
+        cachedLine = line;
+        cachedData = data_;
     }
 
 public:
@@ -78,15 +109,15 @@ public:
     /**
      * create a source provider with a stream
      */
-    explicit SourceProvider(InputSource& stream) : data_(stream.data()), size_(stream.size()), end_(stream.data() + stream.size()) {
+    explicit SourceProvider(InputSource& stream) : SourceProvider(stream.data(), stream.size()) {
 
     }
 
     /**
      * create a source provider with a stream
      */
-    explicit SourceProvider(const char* data, std::size_t size) : data_(data), size_(size), end_(data + size) {
-
+    explicit SourceProvider(const char* data, std::size_t size) : data_(data), size_(size), end_(data + size), cachedData(data) {
+        computeLineStarts(data, size, lineStarts);
     }
 
     /**
@@ -97,6 +128,22 @@ public:
         return data_;
     }
 
+    /**
+     * the end of the data, which should not be read
+     */
+    [[nodiscard]]
+    const char* end_data() const noexcept {
+        return end_;
+    }
+
+    /**
+     * advances over the given number of bytes, the caller must make sure they are present
+     * (lexer uses this to skip character runs in bulk)
+     */
+    inline void advance(std::size_t bytes) noexcept {
+        data_ += bytes;
+    }
+
     /**
      * this allows us to peek a utf8 code point
      * it doesn't advance the data pointer, returns length (num of bytes) in out_len
@@ -180,22 +227,18 @@ public:
         const auto rem = static_cast<std::size_t>(end_ - data_);
         const auto step = (len <= rem) ? len : rem;
         data_ += step;
-        handleCodepointRead(cp); // increment line number
         return cp;
     }
 
     /**
      * reads a single character and returns it
-     * everytime a character is read, it must check if its the line ending character to track lineNumbers
      */
     [[nodiscard]]
     char readCharacter() noexcept {
         if(data_ == end_) {
             return '\0';
         }
-        const auto read = *data_++;
-        handleCharacterRead(read);
-        return read;
+        return *data_++;
     }
 
     /**
@@ -203,14 +246,13 @@ public:
      */
     void increment() noexcept {
         if(data_ == end_) return;
-        handleCharacterRead(*data_++);
+        data_++;
     }
 
     /**
      * increment a peeked code point
      */
     void incrementCodepoint(char32_t cp, std::size_t len) noexcept {
-        handleCodepointRead(cp); // increment line number
         const auto rem = static_cast<std::size_t>(end_ - data_);
         const auto step = (len <= rem) ? len : rem;
         data_ += step;
@@ -256,7 +298,7 @@ public:
      * @return true if incremented by character length = 1, otherwise false
      */
     bool increment(char c) noexcept {
-        return (data_ < end_ && *data_ == c) ? (handleCharacterRead(c), data_++, true) : false;
+        return (data_ < end_ && *data_ == c) ? (data_++, true) : false;
     }
 
     /**
@@ -264,7 +306,8 @@ public:
      */
     [[nodiscard]]
     inline unsigned int getLineNumber() const noexcept {
-        return lineNumber;
+        syncPosition();
+        return cachedLine;
     }
 
     /**
@@ -272,16 +315,18 @@ public:
      */
     [[nodiscard]]
     inline unsigned int getLineCharNumber() const noexcept {
-        return lineCharacterNumber;
+        syncPosition();
+        return cachedCharacter;
     }
 
     /**
      * reset the stream
      */
     void reset() {
-        lineNumber = 0;
-        lineCharacterNumber = 0;
         data_ = end_ - size_;
+        cachedLine = 0;
+        cachedData = data_;
+        cachedCharacter = 0;
     }
 
     /**
@@ -383,15 +428,17 @@ public:
      */
     void restore(const StreamPosition &position) {
         data_ = position.data;
-        lineNumber = position.line;
-        lineCharacterNumber = position.character;
+        cachedLine = position.line;
+        cachedData = position.data;
+        cachedCharacter = position.character;
     }
 
     /**
      * returns the token position at the very current position
      */
     inline Position position() {
-        return { getLineNumber(), getLineCharNumber() };
+        syncPosition();
+        return { cachedLine, cachedCharacter };
     }
 
 };
\ No newline at end of file
@@ -0,0 +1,107 @@
+// Copyright (c) Chemical Language Foundation 2025.
+
+#include "ContentHash.h"
+#include "stream/FileInputSource.h"
+#include <cstring>
+
+namespace {
+
+    constexpr uint64_t Prime1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr uint64_t Prime3 = 0x165667B19E3779F9ULL;
+    constexpr uint64_t Prime4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr uint64_t Prime5 = 0x27D4EB2F165667C5ULL;
+
+    inline uint64_t rotl(uint64_t x, int r) {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    inline uint64_t read64(const char* p) {
+        uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline uint32_t read32(const char* p) {
+        uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline uint64_t round(uint64_t acc, uint64_t input) {
+        acc += input * Prime2;
+        acc = rotl(acc, 31);
+        return acc * Prime1;
+    }
+
+    inline uint64_t merge_round(uint64_t acc, uint64_t val) {
+        acc ^= round(0, val);
+        return acc * Prime1 + Prime4;
+    }
+
+}
+
+uint64_t hash_contents(const char* data, std::size_t size, uint64_t seed) {
+    const char* p = data;
+    const char* const end = data + size;
+    uint64_t h;
+
+    if (size >= 32) {
+        // four independent lanes, so the loop isn't bound by multiply latency
+        uint64_t v1 = seed + Prime1 + Prime2;
+        uint64_t v2 = seed + Prime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - Prime1;
+        const char* const limit = end - 32;
+        do {
+            v1 = round(v1, read64(p));
+            v2 = round(v2, read64(p + 8));
+            v3 = round(v3, read64(p + 16));
+            v4 = round(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = merge_round(h, v1);
+        h = merge_round(h, v2);
+        h = merge_round(h, v3);
+        h = merge_round(h, v4);
+    } else {
+        h = seed + Prime5;
+    }
+
+    h += static_cast<uint64_t>(size);
+
+    while (end - p >= 8) {
+        h ^= round(0, read64(p));
+        h = rotl(h, 27) * Prime1 + Prime4;
+        p += 8;
+    }
+    if (end - p >= 4) {
+        h ^= static_cast<uint64_t>(read32(p)) * Prime1;
+        h = rotl(h, 23) * Prime2 + Prime3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= static_cast<uint64_t>(static_cast<unsigned char>(*p)) * Prime5;
+        h = rotl(h, 11) * Prime1;
+        p++;
+    }
+
+    // avalanche
+    h ^= h >> 33;
+    h *= Prime2;
+    h ^= h >> 29;
+    h *= Prime3;
+    h ^= h >> 32;
+    return h;
+}
+
+bool hash_file_contents(const std::string_view& path, uint64_t& out_hash) {
+    FileInputSource source;
+    auto err = source.open(std::filesystem::path(path));
+    if (err) {
+        return false;
+    }
+    out_hash = hash_contents(source.data(), source.size());
+    return true;
+}
@@ -0,0 +1,25 @@
+// Copyright (c) Chemical Language Foundation 2025.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+/**
+ * fast non cryptographic 64 bit hash of the given bytes (xxHash64 algorithm), used to
+ * detect whether file contents changed, when modification times can't be trusted
+ */
+uint64_t hash_contents(const char* data, std::size_t size, uint64_t seed = 0);
+
+/**
+ * maps the file at given path and hashes its contents, returns false if file couldn't be read
+ */
+bool hash_file_contents(const std::string_view& path, uint64_t& out_hash);
+
+/**
+ * combines hash of a value into the given seed, used to build a single key out of many hashes
+ */
+inline uint64_t combine_content_hash(uint64_t seed, uint64_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
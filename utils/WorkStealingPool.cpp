@@ -0,0 +1,163 @@
+// Copyright (c) Chemical Language Foundation 2025.
+
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+namespace {
+
+    // the pool the current thread is a worker of, with its index, used to push
+    // tasks on the worker's own deque
+    thread_local WorkStealingPool* current_pool = nullptr;
+    thread_local int current_index = -1;
+
+}
+
+WorkStealingPool::WorkStealingPool(int nThreads) {
+    // without a single worker, tasks would only run when some thread helps
+    const auto total = std::max(nThreads, 1);
+    workers.reserve(total);
+    for(int i = 0; i < total; i++) {
+        workers.emplace_back(std::make_unique<Worker>());
+    }
+    threads.reserve(total);
+    for(int i = 0; i < total; i++) {
+        threads.emplace_back([this, i]() {
+            worker_loop(i);
+        });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard guard(sleep_mutex);
+        done.store(true);
+        sleep_cv.notify_all();
+    }
+    for(auto& thread : threads) {
+        if(thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+void WorkStealingPool::enqueue(Task task) {
+    if(current_pool == this) {
+        auto& worker = *workers[current_index];
+        std::lock_guard guard(worker.mutex);
+        worker.tasks.emplace_back(std::move(task));
+    } else {
+        std::lock_guard guard(injection_mutex);
+        injection.emplace_back(std::move(task));
+    }
+    queued.fetch_add(1);
+    // a worker increments idle before checking queued (under the sleep mutex), so either
+    // it sees the task or we see it idle and wake it up
+    if(idle.load() > 0) {
+        std::lock_guard guard(sleep_mutex);
+        sleep_cv.notify_one();
+    }
+}
+
+bool WorkStealingPool::find_task(int index, Task& out) {
+    // own deque, last in first out
+    if(index >= 0) {
+        auto& worker = *workers[index];
+        std::lock_guard guard(worker.mutex);
+        if(!worker.tasks.empty()) {
+            out = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    // tasks pushed from outside the pool
+    {
+        std::lock_guard guard(injection_mutex);
+        if(!injection.empty()) {
+            out = std::move(injection.front());
+            injection.pop_front();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    // steal the oldest task of other workers
+    const auto total = static_cast<int>(workers.size());
+    const auto start = index >= 0 ? index + 1 : 0;
+    for(int i = 0; i < total; i++) {
+        const auto victim_index = (start + i) % total;
+        if(victim_index == index) continue;
+        auto& victim = *workers[victim_index];
+        std::lock_guard guard(victim.mutex);
+        if(!victim.tasks.empty()) {
+            out = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingPool::run_pending_task() {
+    const auto index = current_pool == this ? current_index : -1;
+    Task task;
+    if(find_task(index, task)) {
+        task(index);
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::worker_loop(int index) {
+    current_pool = this;
+    current_index = index;
+    Task task;
+    while(true) {
+        if(find_task(index, task)) {
+            task(index);
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock lock(sleep_mutex);
+        idle.fetch_add(1);
+        sleep_cv.wait(lock, [this]() {
+            return queued.load() > 0 || done.load();
+        });
+        idle.fetch_sub(1);
+        // queued tasks are run before the pool stops
+        if(done.load() && queued.load() == 0) {
+            return;
+        }
+    }
+}
+
+bool TaskGroup::run_one(State& state, int id) {
+    std::function<bool(int id)> task;
+    {
+        std::lock_guard guard(state.mutex);
+        if(state.tasks.empty()) {
+            return false;
+        }
+        task = std::move(state.tasks.front());
+        state.tasks.pop_front();
+    }
+    if(!task(id)) {
+        state.failures.fetch_add(1, std::memory_order_relaxed);
+    }
+    if(state.outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard guard(state.mutex);
+        state.done_cv.notify_all();
+    }
+    return true;
+}
+
+int TaskGroup::wait() {
+    // help with the group's own tasks, instead of blocking
+    while(run_one(*state, -1)) {}
+    // wait for the tasks that were taken by the workers
+    std::unique_lock lock(state->mutex);
+    state->done_cv.wait(lock, [this]() {
+        return state->outstanding.load(std::memory_order_acquire) == 0;
+    });
+    return state->failures.exchange(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,208 @@
+// Copyright (c) Chemical Language Foundation 2025.
+
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
+
+/**
+ * a thread pool where every worker owns a deque of tasks, tasks pushed from a worker thread
+ * go to its own deque and are run last in first out (nested work stays hot on the same thread),
+ * idle workers steal from the front of other workers' deques, tasks pushed from threads outside
+ * the pool go to a shared injection queue
+ *
+ * push has the same signature as ctpl::thread_pool::push (the task receives the index of
+ * the worker running it), so it replaces ctpl::thread_pool without changing call sites
+ */
+class WorkStealingPool {
+public:
+
+    using Task = std::function<void(int id)>;
+
+    /**
+     * creates the pool with given number of worker threads
+     */
+    explicit WorkStealingPool(int nThreads);
+
+    /**
+     * runs all the queued tasks and joins the worker threads
+     */
+    ~WorkStealingPool();
+
+    // deleted
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * get the number of worker threads
+     */
+    int size() const noexcept {
+        return static_cast<int>(threads.size());
+    }
+
+    /**
+     * number of workers sleeping because they found no work
+     */
+    int n_idle() const noexcept {
+        return idle.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * queue the given task, which receives the index of the worker running it
+     * (or -1 when it's run by a thread outside the pool that is helping)
+     */
+    void enqueue(Task task);
+
+    /**
+     * runs a single queued task on the calling thread, returns false if there was none
+     */
+    bool run_pending_task();
+
+    /**
+     * run the function with the given arguments, future gives the result
+     */
+    template<typename F, typename... Rest>
+    auto push(F&& f, Rest&&... rest) -> std::future<decltype(f(0, rest...))> {
+        auto pck = std::make_shared<std::packaged_task<decltype(f(0, rest...))(int)>>(
+            std::bind(std::forward<F>(f), std::placeholders::_1, std::forward<Rest>(rest)...)
+        );
+        enqueue([pck](int id) {
+            (*pck)(id);
+        });
+        return pck->get_future();
+    }
+
+    /**
+     * run the function, future gives the result
+     */
+    template<typename F>
+    auto push(F&& f) -> std::future<decltype(f(0))> {
+        auto pck = std::make_shared<std::packaged_task<decltype(f(0))(int)>>(std::forward<F>(f));
+        enqueue([pck](int id) {
+            (*pck)(id);
+        });
+        return pck->get_future();
+    }
+
+private:
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /**
+     * finds a task for the worker at given index (-1 for threads outside the pool),
+     * own deque first, then injection queue, then other workers' deques
+     */
+    bool find_task(int index, Task& out);
+
+    /**
+     * the loop each worker thread runs
+     */
+    void worker_loop(int index);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    // tasks pushed from outside the pool
+    std::mutex injection_mutex;
+    std::deque<Task> injection;
+
+    // workers sleep on this when no task is found
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_cv;
+
+    // number of queued tasks (not yet taken by a thread)
+    std::atomic<int> queued = 0;
+    std::atomic<int> idle = 0;
+    std::atomic<bool> done = false;
+
+};
+
+/**
+ * fork / join over the pool, tasks given to run are queued in the group and a small task that
+ * runs one of them is pushed on the pool, wait runs the group's queued tasks on the waiting
+ * thread instead of blocking, so the joining thread helps with its own work and never picks up
+ * unrelated long running tasks from the pool
+ *
+ * exceptions are disabled in the compiler, a task reports failure by returning false,
+ * wait gives the number of tasks that failed
+ */
+class TaskGroup {
+public:
+
+    /**
+     * constructor
+     */
+    explicit TaskGroup(WorkStealingPool& pool) : pool(pool), state(std::make_shared<State>()) {
+
+    }
+
+    /**
+     * waits for the tasks of the group, call wait to get the number of failed tasks
+     */
+    ~TaskGroup() {
+        wait();
+    }
+
+    // deleted
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /**
+     * run the function in the group, it receives the worker index (-1 when run by the waiting thread)
+     * the function can return a bool, false counts the task as failed
+     */
+    template<typename F>
+    void run(F&& f) {
+        {
+            std::lock_guard guard(state->mutex);
+            if constexpr (std::is_same_v<std::invoke_result_t<F&, int>, bool>) {
+                state->tasks.emplace_back(std::forward<F>(f));
+            } else {
+                state->tasks.emplace_back([fn = std::forward<F>(f)](int id) mutable {
+                    fn(id);
+                    return true;
+                });
+            }
+        }
+        state->outstanding.fetch_add(1, std::memory_order_relaxed);
+        pool.enqueue([s = state](int id) {
+            run_one(*s, id);
+        });
+    }
+
+    /**
+     * waits for all the tasks run in this group, returns the number of tasks that failed
+     * since the last wait
+     */
+    int wait();
+
+private:
+
+    struct State {
+        std::mutex mutex;
+        std::deque<std::function<bool(int id)>> tasks;
+        std::atomic<int> outstanding = 0;
+        std::atomic<int> failures = 0;
+        std::condition_variable done_cv;
+    };
+
+    /**
+     * runs a single queued task of the group, returns false if none was queued
+     */
+    static bool run_one(State& state, int id);
+
+    WorkStealingPool& pool;
+    std::shared_ptr<State> state;
+
+};